@@ -0,0 +1,40 @@
+// alloc_counting.cpp
+// Replacement global operator new / operator delete that bump
+// AllocCounters (alloc_stats.hpp). Linked only into oopdalloc, so the
+// interactive program, the server and the benchmarks keep the standard
+// allocator. Kept in a translation unit of its own: callers never see
+// the bodies, so the compiler cannot pair a new-expression with the
+// std::free() inside delete.
+
+#include "alloc_stats.hpp"
+
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+
+// Plain and aligned forms: std::pmr's default resource allocates through
+// the aligned ones. Both are released with std::free.
+void *operator new(std::size_t size) {
+    AllocCounters::onAlloc(size);
+    if (void *p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t al) {
+    AllocCounters::onAlloc(size);
+    const std::size_t align = static_cast<std::size_t>(al);
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    if (void *p = std::aligned_alloc(align, rounded)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    if (!p) return;
+    AllocCounters::onFree();
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept { operator delete(p); }
+void operator delete(void *p, std::align_val_t) noexcept { operator delete(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { operator delete(p); }
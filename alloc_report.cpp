@@ -0,0 +1,66 @@
+// alloc_report.cpp
+// Allocation report: loads a CSV with heap-allocated records and again
+// with arena-backed ones, and prints allocation counts, bytes, load and
+// release times and resident memory for each. Built with the counting
+// allocator in alloc_counting.cpp.
+//
+//   make oopdalloc
+//   ./oopdalloc                       (oopd_students.csv)
+//   ./oopdalloc bench_string_300000.csv
+
+#include "student.hpp"
+#include "database.hpp"
+#include "alloc_stats.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <memory>
+#include <chrono>
+
+using ReportDatabase = StudentDatabase<std::string, std::string>;
+
+int main(int argc, char **argv) {
+    if (argc > 2) {
+        std::cerr << "usage: oopdalloc [file.csv]\n";
+        return 2;
+    }
+    const std::string csv = argc == 2 ? argv[1] : "oopd_students.csv";
+
+    std::cout << "Mode    Rows      Allocs   Alloc MiB   Load ms   Frees at release"
+                 "   Release ms   RSS KiB\n";
+    for (bool arena : {false, true}) {
+        auto db = std::make_unique<ReportDatabase>();
+        db->setArenaAllocation(arena);
+        db->getThreadPool();
+
+        AllocStats before = AllocStats::now();
+        auto t0 = std::chrono::steady_clock::now();
+        if (!db->loadFromCSVMapped(csv)) {
+            std::cerr << "Cannot load " << csv << "\n";
+            return 1;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        AllocStats load = AllocStats::now() - before;
+        const std::size_t rows = db->getStudents().size();
+        const std::size_t rss = currentRssKiB();
+
+        before = AllocStats::now();
+        db.reset();
+        auto t2 = std::chrono::steady_clock::now();
+        AllocStats release = AllocStats::now() - before;
+
+        std::cout << std::left << std::setw(8) << (arena ? "arena" : "heap") << std::right
+                  << std::setw(4) << rows << std::setw(12) << load.allocations
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << load.bytes / (1024.0 * 1024.0)
+                  << std::setw(10) << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                  << std::setw(19) << release.frees
+                  << std::setw(13) << std::chrono::duration<double, std::milli>(t2 - t1).count()
+                  << std::setw(10) << rss << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    std::cout << "Peak RSS: " << peakRssKiB() << " KiB\n";
+    return 0;
+}
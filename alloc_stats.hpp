@@ -0,0 +1,73 @@
+#ifndef ALLOC_STATS_HPP
+#define ALLOC_STATS_HPP
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <cstddef>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+// ========================
+// Heap allocation counters and resident memory
+// The counters are bumped by the replacement operator new / operator
+// delete in alloc_counting.cpp, which only the oopdalloc report links;
+// in other programs they stay at zero. Take an AllocStats::now() before
+// and after an operation and subtract. Arena-backed loads show up as a
+// handful of large allocations instead of one per string or vector.
+// ========================
+
+struct AllocCounters {
+    static std::atomic<std::size_t> &allocations() {
+        static std::atomic<std::size_t> n{0};
+        return n;
+    }
+    static std::atomic<std::size_t> &frees() {
+        static std::atomic<std::size_t> n{0};
+        return n;
+    }
+    static std::atomic<std::size_t> &bytes() {   // requested, never decremented
+        static std::atomic<std::size_t> n{0};
+        return n;
+    }
+
+    static void onAlloc(std::size_t size) {
+        allocations().fetch_add(1, std::memory_order_relaxed);
+        bytes().fetch_add(size, std::memory_order_relaxed);
+    }
+    static void onFree() { frees().fetch_add(1, std::memory_order_relaxed); }
+};
+
+struct AllocStats {
+    std::size_t allocations = 0;
+    std::size_t frees       = 0;
+    std::size_t bytes       = 0;
+
+    static AllocStats now() {
+        return {AllocCounters::allocations().load(std::memory_order_relaxed),
+                AllocCounters::frees().load(std::memory_order_relaxed),
+                AllocCounters::bytes().load(std::memory_order_relaxed)};
+    }
+
+    AllocStats operator-(const AllocStats &o) const {
+        return {allocations - o.allocations, frees - o.frees, bytes - o.bytes};
+    }
+};
+
+// Current resident set size in KiB (0 if /proc is unavailable)
+inline std::size_t currentRssKiB() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+// Peak resident set size of the process so far, in KiB
+inline std::size_t peakRssKiB() {
+    struct rusage ru {};
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return static_cast<std::size_t>(ru.ru_maxrss);
+}
+
+#endif // ALLOC_STATS_HPP
@@ -0,0 +1,68 @@
+#ifndef ARENA_VECTOR_HPP
+#define ARENA_VECTOR_HPP
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <cstddef>
+
+// ========================
+// Vector of records that owns the arenas they allocate from
+// A loader asks for an arena (a std::pmr::monotonic_buffer_resource,
+// sized from the input so it usually needs a single upstream block) and
+// builds its records with it: names and course lists then cost a pointer
+// bump instead of a malloc each, and the whole dataset is freed in one
+// step by reset() or the next load.
+//
+// Arenas are not thread-safe, so parallel loaders take one per chunk.
+// Records are always destroyed before the arenas they live in. Copies of
+// the vector (or of records) land on the default heap and do not share
+// its arenas.
+// ========================
+
+template <typename T>
+class ArenaVector : public std::vector<T> {
+private:
+    using Base = std::vector<T>;
+
+    std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> arenas;
+
+public:
+    ArenaVector() = default;
+    ArenaVector(const ArenaVector &o) : Base(o) {}
+    ArenaVector(ArenaVector &&) noexcept = default;
+
+    ArenaVector &operator=(ArenaVector &&o) noexcept {
+        // Our old records go first, while their arenas are still alive
+        Base::operator=(std::move(static_cast<Base &>(o)));
+        arenas = std::move(o.arenas);
+        return *this;
+    }
+
+    ArenaVector &operator=(const ArenaVector &o) {
+        if (this != &o) *this = ArenaVector(o);
+        return *this;
+    }
+
+    ~ArenaVector() { this->clear(); }
+
+    // A fresh arena owned by this vector. `sizeHint` is the expected
+    // total allocation (0 = grow geometrically from a small block).
+    std::pmr::memory_resource *newArena(std::size_t sizeHint = 0) {
+        arenas.push_back(sizeHint
+            ? std::make_unique<std::pmr::monotonic_buffer_resource>(sizeHint)
+            : std::make_unique<std::pmr::monotonic_buffer_resource>());
+        return arenas.back().get();
+    }
+
+    // Destroys every record, then releases every arena
+    void reset() {
+        this->clear();
+        arenas.clear();
+    }
+
+    std::size_t arenaCount() const { return arenas.size(); }
+};
+
+#endif // ARENA_VECTOR_HPP
@@ -0,0 +1,350 @@
+// bench.cpp
+// Benchmark driver: times loading, sorting, index building and queries
+// over generated datasets and writes the results as JSON, so runs from
+// two builds can be diffed.
+//
+//   make bench                                  (default sizes)
+//   ./oopdbench --sizes 3000,1000000,10000000 --threads 8 --reps 7 --out bench.json
+//   ./oopdbench --snapshot-readers 4             (also stress snapshot reads)
+
+#include "student.hpp"
+#include "database.hpp"
+#include "generator.hpp"
+#include "versioned_database.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <type_traits>
+
+using BenchDatabase        = StudentDatabase<std::string, std::string>;
+using NumericBenchDatabase = StudentDatabase<unsigned int, int>;
+
+// ---------------- OPTIONS ----------------
+struct BenchOptions {
+    std::vector<std::size_t> sizes   = {3000, 30000, 300000};
+    std::size_t              threads = std::max(2u, std::thread::hardware_concurrency());
+    std::size_t              reps    = 5;
+    std::size_t              warmup  = 1;
+    std::string              out     = "bench.json";
+    std::string              dir     = ".";
+    bool                     keep    = false;   // keep generated CSVs
+    bool                     metrics = false;   // run with instrumentation on
+    bool                     strings = true;    // key types to run: string rolls/courses
+    bool                     numeric = true;    // and/or unsigned rolls, int courses
+    std::size_t              readers = 0;       // snapshot stress threads (0 = skip)
+};
+
+static void usage() {
+    std::cerr << "usage: oopdbench [--sizes N,N,...] [--threads N] [--reps N]"
+                 " [--warmup N] [--out FILE|-] [--dir DIR] [--keep] [--metrics]\n"
+                 "                 [--keys string|numeric|both] [--snapshot-readers N]\n";
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions &o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](std::string &v) {
+            if (i + 1 >= argc) return false;
+            v = argv[++i];
+            return true;
+        };
+        auto count = [&](std::size_t &v) {
+            std::string s;
+            if (!value(s)) return false;
+            v = std::strtoull(s.c_str(), nullptr, 10);
+            return v > 0 || s == "0";
+        };
+
+        std::string s;
+        if (arg == "--sizes") {
+            if (!value(s)) return false;
+            o.sizes.clear();
+            std::stringstream ss(s);
+            for (std::string item; std::getline(ss, item, ',');) {
+                std::size_t n = std::strtoull(item.c_str(), nullptr, 10);
+                if (n == 0) return false;
+                o.sizes.push_back(n);
+            }
+            if (o.sizes.empty()) return false;
+        } else if (arg == "--threads") {
+            if (!count(o.threads) || o.threads == 0) return false;
+        } else if (arg == "--reps") {
+            if (!count(o.reps) || o.reps == 0) return false;
+        } else if (arg == "--warmup") {
+            if (!count(o.warmup)) return false;
+        } else if (arg == "--out") {
+            if (!value(o.out)) return false;
+        } else if (arg == "--dir") {
+            if (!value(o.dir)) return false;
+        } else if (arg == "--keep") {
+            o.keep = true;
+        } else if (arg == "--metrics") {
+            o.metrics = true;
+        } else if (arg == "--keys") {
+            if (!value(s) || (s != "string" && s != "numeric" && s != "both")) return false;
+            o.strings = s != "numeric";
+            o.numeric = s != "string";
+        } else if (arg == "--snapshot-readers") {
+            if (!count(o.readers)) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------------- MEASUREMENT ----------------
+struct BenchResult {
+    std::string name;
+    std::string keys;          // "string" or "numeric"
+    std::size_t rows    = 0;
+    std::size_t threads = 1;
+    std::vector<long long> samplesNs;
+    std::size_t result  = 0;   // what the operation produced (rows, hits)
+};
+
+// Times `op` warmup + reps times; only the reps are kept. op returns a
+// result count (rows loaded, query hits), recorded from the last run.
+static BenchResult measure(const std::string &name, std::size_t rows, std::size_t threads,
+                           const BenchOptions &o, const std::function<std::size_t()> &op) {
+    using clock = std::chrono::steady_clock;
+    BenchResult r;
+    r.name = name;
+    r.rows = rows;
+    r.threads = threads;
+
+    std::cerr << "  " << name << " (" << threads << " threads)..." << std::flush;
+    for (std::size_t i = 0; i < o.warmup + o.reps; ++i) {
+        auto t0 = clock::now();
+        r.result = op();
+        auto t1 = clock::now();
+        if (i >= o.warmup)
+            r.samplesNs.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    std::cerr << " done\n";
+    return r;
+}
+
+// Nearest-rank percentile of sorted samples
+static long long percentile(const std::vector<long long> &sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(p / 100.0 * sorted.size() + 0.999999);
+    if (rank == 0) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+static void writeJson(std::ostream &os, const BenchOptions &o,
+                      const std::vector<BenchResult> &results) {
+    os << "{\n  \"benchmark\": \"oopdassign4\",\n"
+       << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+       << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+       << "  \"reps\": " << o.reps << ",\n  \"warmup\": " << o.warmup << ",\n"
+       << "  \"metrics_enabled\": " << (o.metrics ? "true" : "false") << ",\n"
+       << "  \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        std::vector<long long> s = r.samplesNs;
+        std::sort(s.begin(), s.end());
+        const long long sum = std::accumulate(s.begin(), s.end(), 0LL);
+
+        os << "    {\"name\": \"" << r.name << "\", \"keys\": \"" << r.keys
+           << "\", \"rows\": " << r.rows
+           << ", \"threads\": " << r.threads << ", \"result\": " << r.result
+           << ", \"min_ns\": " << s.front()
+           << ", \"median_ns\": " << percentile(s, 50)
+           << ", \"p99_ns\": " << percentile(s, 99)
+           << ", \"mean_ns\": " << sum / static_cast<long long>(s.size())
+           << ", \"max_ns\": " << s.back() << ", \"samples_ns\": [";
+        for (std::size_t k = 0; k < r.samplesNs.size(); ++k)
+            os << (k ? ", " : "") << r.samplesNs[k];
+        os << "]}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]";
+    if (o.metrics) {
+        // The database's own counters and histograms over the whole run
+        std::string m = Metrics::toJson();
+        for (std::size_t p = m.find('\n'); p != std::string::npos && p + 1 < m.size();
+             p = m.find('\n', p + 3))
+            m.insert(p + 1, "  ");
+        m.pop_back();
+        os << ",\n  \"metrics\": " << m;
+    }
+    os << "\n}\n";
+}
+
+// ---------------- SNAPSHOT STRESS ----------------
+// Reader threads query frozen versions while each rep reloads the CSV
+// into a new version and publishes it; nobody blocks anybody. A version
+// that changes under its reader is an inconsistent read. Returns false
+// if there were any.
+template <typename DB>
+static bool benchSnapshotReads(const std::string &path, std::size_t rows,
+                               const BenchOptions &o, BenchResult &result) {
+    using RollT   = typename DB::RollType;
+    using CourseT = typename DB::CourseCodeType;
+
+    const auto query = parseQuery<RollT, CourseT>("branch=cse and year>=2022");
+    VersionedDatabase<DB> versions(std::make_shared<ThreadPool>(o.threads));
+    versions.rebuild([&](DB &next) { next.loadFromCSVMapped(path); });
+
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> reads{0}, torn{0};
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < o.readers; ++t) {
+        threads.emplace_back([&] {
+            do {
+                auto snap = versions.snapshot();
+                const std::size_t live = snap->liveCount();
+                snap->select(query);
+                if (snap->liveCount() != live || snap->getColumns().size() != live)
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                reads.fetch_add(1, std::memory_order_relaxed);
+            } while (!done.load(std::memory_order_acquire));
+        });
+    }
+
+    result = measure("reload_under_readers", rows, o.readers, o, [&] {
+        versions.rebuild([&](DB &next) { next.loadFromCSVMapped(path); });
+        return versions.snapshot()->liveCount();
+    });
+    done.store(true, std::memory_order_release);
+    for (auto &th : threads) th.join();
+
+    std::cerr << "  " << versions.version() << " versions published, " << reads.load()
+              << " snapshot queries, " << torn.load() << " inconsistent reads\n";
+    return torn.load() == 0;
+}
+
+// ---------------- SUITE ----------------
+// One pass over a generated dataset with DB's key types. `keys` labels
+// the results; numeric runs use integer course codes throughout. False
+// if a consistency check failed.
+template <typename DB>
+static bool benchSize(std::size_t rows, const BenchOptions &o, const std::string &keys,
+                      std::vector<BenchResult> &results) {
+    using RollT   = typename DB::RollType;
+    using CourseT = typename DB::CourseCodeType;
+    constexpr bool numeric = std::is_integral<CourseT>::value;
+
+    const std::string path = o.dir + "/bench_" + keys + "_" + std::to_string(rows) + ".csv";
+    std::cerr << rows << " rows (" << keys << " keys): generating " << path << "\n";
+    GeneratorOptions gen;
+    gen.rows = rows;
+    gen.seed = 42 + rows;
+    gen.threads = o.threads;
+    gen.numericCourses = numeric;
+    if (!DatasetGenerator(gen).write(path)) {
+        std::cerr << "Cannot write " << path << "\n";
+        return false;
+    }
+
+    auto add = [&](BenchResult r) {
+        r.keys = keys;
+        results.push_back(std::move(r));
+    };
+
+    DB db;
+    add(measure("load_csv", rows, 1, o, [&] {
+        db.loadFromCSV(path);
+        return db.getStudents().size();
+    }));
+
+    // One pool per thread count, so the sort really runs on t workers
+    for (std::size_t t = 1; t <= o.threads; ++t) {
+        db.setThreadPool(std::make_shared<ThreadPool>(t));
+        add(measure("parallel_sort_by_roll", rows, t, o, [&] {
+            db.parallelSortByRoll(t);
+            return db.getSortedIndices().size();
+        }));
+    }
+    db.setThreadPool(std::make_shared<ThreadPool>(o.threads));
+
+    add(measure("build_grade_index", rows, o.threads, o, [&] {
+        db.buildGradeIndex();
+        std::size_t entries = 0;
+        db.getGradeIndex().allCourses().forEach(
+            [&entries](auto, const auto &grades) { entries += grades.size(); });
+        return entries;
+    }));
+
+    // Every roll once, in file order
+    std::vector<RollT> rolls;
+    rolls.reserve(db.getStudents().size());
+    for (const auto &s : db.getStudents()) rolls.push_back(s.getRoll());
+    add(measure("roll_lookup", rows, 1, o, [&] {
+        std::size_t hits = 0;
+        for (const auto &r : rolls) hits += db.findRowByRoll(r) != DB::NOT_FOUND;
+        return hits;
+    }));
+
+    CourseT graded{}, current{};
+    if constexpr (numeric) {
+        graded  = 12345;
+        current = 10001;   // first numeric current course
+    } else {
+        graded  = "12345";
+        current = "OOPD";
+    }
+
+    add(measure("query_course_min_grade", rows, 1, o, [&] {
+        return db.queryByCourseAndMinGrade(graded, 9.0).size();
+    }));
+
+    add(measure("oopd_filter", rows, 1, o, [&] {
+        return db.studentsWithCourse(current).cardinality();
+    }));
+
+    bool ok = true;
+    if (o.readers > 0) {
+        BenchResult r;
+        ok = benchSnapshotReads<DB>(path, rows, o, r);
+        add(std::move(r));
+    }
+
+    if (!o.keep) std::remove(path.c_str());
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions o;
+    if (!parseOptions(argc, argv, o)) {
+        usage();
+        return 2;
+    }
+
+    // Off by default, so the timings show the uninstrumented hot paths
+    Metrics::enable(o.metrics);
+
+    std::vector<BenchResult> results;
+    bool ok = true;
+    for (std::size_t rows : o.sizes) {
+        if (o.strings) ok = benchSize<BenchDatabase>(rows, o, "string", results) && ok;
+        if (o.numeric) ok = benchSize<NumericBenchDatabase>(rows, o, "numeric", results) && ok;
+    }
+
+    if (o.out == "-") {
+        writeJson(std::cout, o, results);
+    } else {
+        std::ofstream out(o.out);
+        if (!out) {
+            std::cerr << "Cannot open " << o.out << " for writing.\n";
+            return 1;
+        }
+        writeJson(out, o, results);
+        std::cerr << "Wrote " << results.size() << " results to " << o.out << "\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#ifndef COLUMN_STORE_HPP
+#define COLUMN_STORE_HPP
+
+#include "student.hpp"
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+
+// ========================
+// Columnar (struct-of-arrays) student storage
+// Each attribute lives in its own contiguous array; branches and course
+// codes are stored as their interned ids (symbol_table.hpp), and the
+// per-student course lists are stored CSR-style (offsets[i]..offsets[i+1]
+// into a flat value array).
+// Scanning one attribute therefore touches only that attribute's bytes.
+// ========================
+
+template <typename RollT, typename CourseCodeT>
+class ColumnStore {
+public:
+    using StudentT  = Student<RollT, CourseCodeT>;
+    using KeyTraits = CourseKeyTraits<CourseCodeT>;
+    using CourseKey = typename KeyTraits::Key;
+
+private:
+    // Columns (one entry per student, original order)
+    std::vector<RollT>         roll;
+    std::vector<std::string>   name;
+    std::vector<BranchId>      branch;
+    std::vector<std::int32_t>  startYear;
+    std::vector<std::size_t>   source;      // row in the source vector
+
+    // CSR course lists
+    std::vector<std::size_t>   currentOffsets{0};
+    std::vector<CourseKey>     currentCourses;
+    std::vector<std::size_t>   completedOffsets{0};
+    std::vector<CourseKey>     completedCourses;
+    std::vector<double>        completedGrades;
+
+public:
+    // ------------------------
+    // Lightweight read-only view of one row. It exposes the same getters
+    // as Student, so printing code can take either.
+    // ------------------------
+    class StudentView {
+    private:
+        const ColumnStore *store;
+        std::size_t row;
+
+    public:
+        // Completed courses are split across two columns, so this range
+        // walks a CSR slice by position rather than by pointer
+        class CompletedRange {
+        private:
+            const ColumnStore *store;
+            std::size_t first, last;
+
+        public:
+            class iterator {
+            private:
+                const ColumnStore *store;
+                std::size_t k;
+
+            public:
+                iterator(const ColumnStore *store, std::size_t k)
+                    : store(store), k(k) {}
+                std::pair<const CourseCodeT &, double> operator*() const {
+                    return {KeyTraits::code(store->completedCourses[k]),
+                            store->completedGrades[k]};
+                }
+                iterator &operator++() { ++k; return *this; }
+                bool operator!=(const iterator &o) const { return k != o.k; }
+                bool operator==(const iterator &o) const { return k == o.k; }
+            };
+
+            CompletedRange(const ColumnStore *store, std::size_t first,
+                           std::size_t last)
+                : store(store), first(first), last(last) {}
+            iterator begin() const { return iterator(store, first); }
+            iterator end() const { return iterator(store, last); }
+            std::size_t size() const { return last - first; }
+            bool empty() const { return first == last; }
+        };
+
+        StudentView(const ColumnStore *store, std::size_t row)
+            : store(store), row(row) {}
+
+        std::size_t index() const { return row; }
+
+        const std::string &getName() const { return store->name[row]; }
+        const RollT &getRoll() const { return store->roll[row]; }
+        const std::string &getBranch() const { return branchName(store->branch[row]); }
+        int getStartYear() const { return store->startYear[row]; }
+
+        CourseCodeRange<CourseCodeT> getCurrentCourses() const {
+            const CourseKey *base = store->currentCourses.data();
+            return {base + store->currentOffsets[row],
+                    base + store->currentOffsets[row + 1]};
+        }
+
+        CompletedRange getCompletedCourses() const {
+            return CompletedRange(store, store->completedOffsets[row],
+                                  store->completedOffsets[row + 1]);
+        }
+
+        friend std::ostream &operator<<(std::ostream &os, const StudentView &s) {
+            return writeStudentSummary(os, s);
+        }
+
+        // Copies the row back into a full Student
+        StudentT toStudent() const {
+            StudentT s(getName(), getRoll(), store->branch[row], getStartYear());
+            for (std::size_t k = store->currentOffsets[row];
+                 k < store->currentOffsets[row + 1]; ++k)
+                s.enrollInCourseKey(store->currentCourses[k]);
+            for (std::size_t k = store->completedOffsets[row];
+                 k < store->completedOffsets[row + 1]; ++k)
+                s.completeCourseKey(store->completedCourses[k],
+                                    store->completedGrades[k]);
+            return s;
+        }
+    };
+
+    // ------------------------
+    // Building
+    // ------------------------
+    void clear() {
+        *this = ColumnStore();
+    }
+
+    // `sourceRow` is the record's index in the vector it was copied from
+    void append(const StudentT &s, std::size_t sourceRow) {
+        source.push_back(sourceRow);
+        roll.push_back(s.getRoll());
+        name.emplace_back(s.getName());
+        branch.push_back(s.getBranchId());
+        startYear.push_back(s.getStartYear());
+
+        for (auto c : s.getCurrentCourseKeys())
+            currentCourses.push_back(c);
+        currentOffsets.push_back(currentCourses.size());
+
+        for (const auto &p : s.getCompletedCourseKeys()) {
+            completedCourses.push_back(p.first);
+            completedGrades.push_back(p.second);
+        }
+        completedOffsets.push_back(completedCourses.size());
+    }
+
+    void build(const std::vector<StudentT> &students) {
+        build(students, [](std::size_t) { return true; });
+    }
+
+    // Builds from the rows i of `students` for which keep(i) holds
+    template <typename Keep>
+    void build(const std::vector<StudentT> &students, Keep keep) {
+        clear();
+
+        std::size_t nCurrent = 0, nCompleted = 0;
+        for (const auto &s : students) {
+            nCurrent   += s.getCurrentCourses().size();
+            nCompleted += s.getCompletedCourses().size();
+        }
+
+        roll.reserve(students.size());
+        name.reserve(students.size());
+        branch.reserve(students.size());
+        startYear.reserve(students.size());
+        source.reserve(students.size());
+        currentOffsets.reserve(students.size() + 1);
+        completedOffsets.reserve(students.size() + 1);
+        currentCourses.reserve(nCurrent);
+        completedCourses.reserve(nCompleted);
+        completedGrades.reserve(nCompleted);
+
+        for (std::size_t i = 0; i < students.size(); ++i)
+            if (keep(i)) append(students[i], i);
+    }
+
+    // ------------------------
+    // Access
+    // ------------------------
+    std::size_t size() const { return roll.size(); }
+    StudentView view(std::size_t row) const { return StudentView(this, row); }
+    StudentView operator[](std::size_t row) const { return view(row); }
+
+    // Raw columns, for scans that want to stream one attribute
+    const std::vector<RollT> &rolls() const { return roll; }
+    const std::vector<BranchId> &branches() const { return branch; }
+    const std::vector<std::int32_t> &startYears() const { return startYear; }
+    const std::vector<std::size_t> &sourceRows() const { return source; }
+    const std::vector<std::size_t> &currentCourseOffsets() const { return currentOffsets; }
+    const std::vector<CourseKey> &currentCourseKeys() const { return currentCourses; }
+    const std::vector<std::size_t> &completedCourseOffsets() const { return completedOffsets; }
+    const std::vector<CourseKey> &completedCourseKeys() const { return completedCourses; }
+    const std::vector<double> &completedCourseGrades() const { return completedGrades; }
+
+    // ------------------------
+    // Column scans
+    // ------------------------
+    std::vector<std::size_t> selectByBranch(const std::string &b) const {
+        std::vector<std::size_t> rows;
+        BranchId id = branchSymbols().find(b);
+        if (id == SymbolTable<BranchId>::NONE) return rows;
+
+        for (std::size_t i = 0; i < branch.size(); ++i)
+            if (branch[i] == id) rows.push_back(i);
+        return rows;
+    }
+
+    std::vector<std::size_t> selectByStartYear(int fromYear, int toYear) const {
+        std::vector<std::size_t> rows;
+        for (std::size_t i = 0; i < startYear.size(); ++i)
+            if (startYear[i] >= fromYear && startYear[i] <= toYear) rows.push_back(i);
+        return rows;
+    }
+
+    // Mean grade over everyone who completed `course` (0 if nobody did)
+    double meanGrade(const CourseCodeT &course, std::size_t *count = nullptr) const {
+        const CourseKey id = KeyTraits::find(course);
+        double sum = 0.0;
+        std::size_t n = 0;
+
+        for (std::size_t k = 0; k < completedCourses.size(); ++k) {
+            if (completedCourses[k] == id) {
+                sum += completedGrades[k];
+                ++n;
+            }
+        }
+
+        if (count) *count = n;
+        return n ? sum / static_cast<double>(n) : 0.0;
+    }
+};
+
+#endif // COLUMN_STORE_HPP
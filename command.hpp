@@ -0,0 +1,276 @@
+#ifndef COMMAND_HPP
+#define COMMAND_HPP
+
+#include "csv_parse.hpp"
+#include "enrollment_index.hpp"
+#include "record_writer.hpp"
+#include "metrics.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <stdexcept>
+#include <cctype>
+#include <cstddef>
+
+// ========================
+// Text query commands (one per line), shared by the socket server and
+// batch mode. Keywords are case-insensitive.
+//
+//   PING
+//   ROLL <roll>
+//   GRADE <course> [min]          completed <course> with grade >= min (9)
+//   RANGE <course> <lo> <hi>      grades in [lo, hi], best first
+//   TOPK <course> <k>             the k best grades
+//   COURSE <course> [current|completed|any]
+//   OOPD                          COURSE OOPD any
+//   QUERY <query text>            see parseQuery() in query.hpp
+//   SORT [limit] [offset]         students in roll order (needs a sorted
+//                                 database; limit 0 = all)
+//   METRICS [json|prometheus]
+//   RELOAD                        reload the CSV (server only)
+//
+// Every reply is "OK <n>" followed by n lines (student records as JSON
+// Lines), or a single "ERR <message>" line. Blank lines and lines
+// starting with '#' are not commands.
+// ========================
+
+enum class CommandKind { Ping, Roll, Grade, Range, TopK, Course, Query, Sort, Metrics, Reload };
+
+struct Command {
+    CommandKind kind = CommandKind::Ping;
+    std::string arg;            // roll, course, query text or metrics format
+    double      lo = 9.0, hi = 10.0;
+    std::size_t k  = 0;         // TOPK count, SORT limit
+    std::size_t offset = 0;     // SORT offset
+    CourseRole  role = CourseRole::Any;
+};
+
+inline bool isCommandLine(std::string_view line) {
+    line = trimView(line);
+    return !line.empty() && line.front() != '#';
+}
+
+// Parses one command line; on failure returns false and sets `error`
+inline bool parseCommand(std::string_view line, Command &cmd, std::string &error) {
+    cmd = Command();
+    line = trimView(line);
+
+    std::vector<std::string_view> words;
+    for (std::string_view rest = line; !(rest = trimView(rest)).empty();) {
+        std::size_t end = 0;
+        while (end < rest.size() && !isSpaceChar(rest[end])) ++end;
+        words.push_back(rest.substr(0, end));
+        rest.remove_prefix(end);
+    }
+    if (words.empty()) {
+        error = "empty command";
+        return false;
+    }
+
+    std::string verb(words[0]);
+    for (auto &c : verb) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    auto arity = [&](std::size_t lo, std::size_t hi) {
+        if (words.size() - 1 >= lo && words.size() - 1 <= hi) return true;
+        error = verb + ": wrong number of arguments";
+        return false;
+    };
+    auto number = [&](std::string_view w, auto &out) {
+        if (parseNumber(w, out)) return true;
+        error = verb + ": bad number '" + std::string(w) + "'";
+        return false;
+    };
+
+    if (verb == "PING") {
+        cmd.kind = CommandKind::Ping;
+        return arity(0, 0);
+    }
+    if (verb == "ROLL") {
+        cmd.kind = CommandKind::Roll;
+        if (!arity(1, 1)) return false;
+        cmd.arg = std::string(words[1]);
+        return true;
+    }
+    if (verb == "GRADE") {
+        cmd.kind = CommandKind::Grade;
+        if (!arity(1, 2)) return false;
+        cmd.arg = std::string(words[1]);
+        return words.size() < 3 || number(words[2], cmd.lo);
+    }
+    if (verb == "RANGE") {
+        cmd.kind = CommandKind::Range;
+        if (!arity(3, 3)) return false;
+        cmd.arg = std::string(words[1]);
+        return number(words[2], cmd.lo) && number(words[3], cmd.hi);
+    }
+    if (verb == "TOPK") {
+        cmd.kind = CommandKind::TopK;
+        if (!arity(2, 2)) return false;
+        cmd.arg = std::string(words[1]);
+        return number(words[2], cmd.k);
+    }
+    if (verb == "COURSE" || verb == "OOPD") {
+        cmd.kind = CommandKind::Course;
+        if (verb == "OOPD") {
+            cmd.arg = "OOPD";
+            return arity(0, 0);
+        }
+        if (!arity(1, 2)) return false;
+        cmd.arg = std::string(words[1]);
+        if (words.size() == 3) {
+            std::string role(words[2]);
+            for (auto &c : role) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            if (role == "current") cmd.role = CourseRole::Current;
+            else if (role == "completed") cmd.role = CourseRole::Completed;
+            else if (role != "any") {
+                error = "COURSE: role must be current, completed or any";
+                return false;
+            }
+        }
+        return true;
+    }
+    if (verb == "QUERY") {
+        cmd.kind = CommandKind::Query;
+        if (!arity(1, words.size())) return false;
+        cmd.arg = std::string(trimView(line.substr(words[1].data() - line.data())));
+        return true;
+    }
+    if (verb == "SORT") {
+        cmd.kind = CommandKind::Sort;
+        if (!arity(0, 2)) return false;
+        return (words.size() < 2 || number(words[1], cmd.k)) &&
+               (words.size() < 3 || number(words[2], cmd.offset));
+    }
+    if (verb == "METRICS") {
+        cmd.kind = CommandKind::Metrics;
+        if (!arity(0, 1)) return false;
+        cmd.arg = words.size() == 2 ? std::string(words[1]) : "json";
+        if (cmd.arg != "json" && cmd.arg != "prometheus") {
+            error = "METRICS: format must be json or prometheus";
+            return false;
+        }
+        return true;
+    }
+    if (verb == "RELOAD") {
+        cmd.kind = CommandKind::Reload;
+        return arity(0, 0);
+    }
+
+    error = "unknown command '" + std::string(words[0]) + "'";
+    return false;
+}
+
+// Runs read-only commands against a database; RELOAD is left to the
+// caller, which owns the database's lifetime
+template <typename DB>
+struct CommandRunner {
+    static void reply(std::string &out, std::size_t lines, const std::string &body) {
+        out += "OK ";
+        char tmp[24];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), lines);
+        out.append(tmp, res.ptr);
+        out += '\n';
+        out += body;
+    }
+
+    static void error(std::string &out, std::string_view msg) {
+        out += "ERR ";
+        for (char c : msg) out += c == '\n' ? ' ' : c;
+        out += '\n';
+    }
+
+    // Appends the reply to `cmd` to `out`
+    static void run(const DB &db, const Command &cmd, std::string &out) {
+        const auto &students = db.getStudents();
+        std::string body;
+        std::size_t lines = 0;
+        auto record = [&](std::size_t row) {
+            RecordWriter::format(body, students[row], OutputFormat::JSONL);
+            ++lines;
+        };
+
+        try {
+            switch (cmd.kind) {
+            case CommandKind::Ping:
+                break;
+
+            case CommandKind::Roll: {
+                typename DB::RollType roll{};
+                if (!parseKey(cmd.arg, roll)) return error(out, "ROLL: bad roll '" + cmd.arg + "'");
+                db.forEachRowWithRoll(roll, [&](std::size_t row) { record(row); });
+                break;
+            }
+
+            case CommandKind::Grade:
+            case CommandKind::Range:
+            case CommandKind::TopK: {
+                typename DB::CourseCodeType course{};
+                if (!parseKey(cmd.arg, course)) return error(out, "bad course '" + cmd.arg + "'");
+                if (cmd.kind == CommandKind::Grade) {
+                    for (const auto *s : db.queryByCourseAndMinGrade(course, cmd.lo)) {
+                        RecordWriter::format(body, *s, OutputFormat::JSONL);
+                        ++lines;
+                    }
+                } else {
+                    auto range = cmd.kind == CommandKind::Range
+                                     ? db.queryByCourseGradeRange(course, cmd.lo, cmd.hi)
+                                     : db.topKByCourse(course, cmd.k);
+                    for (auto entry : range) record(entry.row);
+                }
+                break;
+            }
+
+            case CommandKind::Course: {
+                typename DB::CourseCodeType course{};
+                if (!parseKey(cmd.arg, course)) return error(out, "bad course '" + cmd.arg + "'");
+                db.studentsWithCourse(course, cmd.role).forEach(record);
+                break;
+            }
+
+            case CommandKind::Query:
+                for (std::size_t row : db.select(cmd.arg)) record(row);
+                break;
+
+            case CommandKind::Sort: {
+                const auto &sorted = db.getSortedIndices();
+                if (sorted.empty() && db.liveCount() > 0)
+                    return error(out, "SORT: database is not sorted");
+                std::size_t skip = cmd.offset;
+                for (std::size_t row : sorted) {
+                    if (db.isRemoved(row)) continue;
+                    if (skip) {
+                        --skip;
+                        continue;
+                    }
+                    if (cmd.k && lines == cmd.k) break;
+                    record(row);
+                }
+                break;
+            }
+
+            case CommandKind::Metrics:
+                body = cmd.arg == "prometheus" ? Metrics::toPrometheus() : Metrics::toJson();
+                for (char c : body) lines += c == '\n';
+                break;
+
+            case CommandKind::Reload:
+                return error(out, "RELOAD is not available here");
+            }
+        } catch (const std::exception &e) {
+            return error(out, e.what());
+        }
+        reply(out, lines, body);
+    }
+
+    // Parses and runs one line
+    static void runLine(const DB &db, std::string_view line, std::string &out) {
+        Command cmd;
+        std::string err;
+        if (!parseCommand(line, cmd, err)) return error(out, err);
+        run(db, cmd, out);
+    }
+};
+
+#endif // COMMAND_HPP
@@ -0,0 +1,305 @@
+#ifndef CSV_LOG_HPP
+#define CSV_LOG_HPP
+
+#include "student.hpp"
+#include "csv_parse.hpp"
+#include "mapped_file.hpp"
+
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <charconv>
+#include <type_traits>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ========================
+// Append-only CSV log with group commit
+// The student CSV doubles as the write-ahead log: new rows are only
+// ever appended, and the loaders replay the file front to back. The log
+// keeps one O_APPEND descriptor open, formats rows with std::to_chars
+// into a reusable buffer, and commit() hands the whole batch to the
+// kernel in one write() followed by one fdatasync().
+//
+// Durability:
+//   PerBatch  every commit() is synced before it returns
+//   Interval  commit() writes, but syncs only when the last sync is
+//             older than the interval; close() always syncs
+//
+// On open, an unterminated last line is given its newline, so the next
+// append starts a row of its own. Nothing is ever cut: a write torn by a
+// crash and a row typed without a final newline look the same, so the
+// loaders decide (a torn row that no longer parses is skipped with a
+// warning). stats().completedLastLine tells the caller to warn.
+// ========================
+
+enum class Durability { PerBatch, Interval };
+
+struct CsvLogOptions {
+    Durability                durability = Durability::PerBatch;
+    std::chrono::milliseconds interval{100};
+    std::size_t               maxBuffer  = 1 << 20;   // commit early past this
+};
+
+class CsvAppendLog {
+public:
+    static constexpr const char *HEADER =
+        "name,roll,branch,startYear,currentCourses,completedCourses\n";
+
+    struct Stats {
+        std::size_t rows    = 0;   // rows appended
+        std::size_t commits = 0;   // write() batches
+        std::size_t syncs   = 0;   // fdatasync() calls
+        std::size_t bytes   = 0;
+        bool completedLastLine = false;   // open() added a missing newline
+    };
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int           fd = -1;
+    std::string   path;
+    CsvLogOptions opts;
+    std::string   buffer;
+    std::size_t   pendingRows = 0;
+    bool          dirty = false;   // written but not yet synced
+    Clock::time_point lastSync = Clock::now();
+    Stats         st;
+
+    // ---- Formatting ----
+    template <typename T>
+    static void appendField(std::string &out, const T &v) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            char tmp[32];
+            auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+            out.append(tmp, res.ptr);
+        } else {
+            out += std::string_view(v);
+        }
+    }
+
+    // Same text as std::to_string(double): fixed, six decimals
+    static void appendGrade(std::string &out, double g) {
+        char tmp[64];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), g, std::chars_format::fixed, 6);
+        out.append(tmp, res.ptr);
+    }
+
+    bool writeAll(const char *p, std::size_t n) { return writeAll(fd, p, n); }
+
+    bool writeAll(int to, const char *p, std::size_t n) {
+        while (n > 0) {
+            ssize_t w = ::write(to, p, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += w;
+            n -= static_cast<std::size_t>(w);
+            st.bytes += static_cast<std::size_t>(w);
+        }
+        return true;
+    }
+
+    // Ends an unterminated last line; never removes anything
+    void recover() {
+        struct stat sb {};
+        if (::fstat(fd, &sb) != 0 || sb.st_size == 0) return;
+
+        char last;
+        if (::pread(fd, &last, 1, sb.st_size - 1) != 1 || last == '\n') return;
+        st.completedLastLine = writeAll("\n", 1);
+    }
+
+    // Replaces the file with `content` without ever truncating it in
+    // place: the text goes to <path>.tmp, is synced, and is renamed over
+    // the CSV, so a crash or a full disk leaves either the old file or
+    // the new one. The temp file is opened for appending and becomes the
+    // log's descriptor once renamed; nothing is reopened, so on failure
+    // the log is still on the old file and on success on the new one.
+    bool replaceFile(const std::string &content) {
+        const std::string tmpPath = path + ".tmp";
+        int tmp = ::open(tmpPath.c_str(), O_RDWR | O_APPEND | O_CREAT | O_TRUNC | O_CLOEXEC,
+                         0644);
+        if (tmp < 0) return false;
+        const bool ok = writeAll(tmp, content.data(), content.size()) && ::fdatasync(tmp) == 0;
+        ++st.syncs;
+        if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            ::close(tmp);
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        ++st.commits;
+
+        ::close(fd);
+        fd = tmp;
+        dirty = false;
+        lastSync = Clock::now();
+        return true;
+    }
+
+public:
+    CsvAppendLog() = default;
+
+    explicit CsvAppendLog(const std::string &path, CsvLogOptions o = CsvLogOptions()) {
+        open(path, o);
+    }
+
+    ~CsvAppendLog() { close(); }
+
+    CsvAppendLog(const CsvAppendLog &) = delete;
+    CsvAppendLog &operator=(const CsvAppendLog &) = delete;
+
+    bool open(const std::string &path, CsvLogOptions o = CsvLogOptions()) {
+        close();
+        opts = o;
+        this->path = path;
+        fd = ::open(path.c_str(), O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        recover();
+        lastSync = Clock::now();
+        return true;
+    }
+
+    // Commits and syncs anything pending, then closes the descriptor
+    void close() {
+        if (fd < 0) return;
+        commit();
+        sync();
+        ::close(fd);
+        fd = -1;
+    }
+
+    bool isOpen() const { return fd >= 0; }
+    const Stats &stats() const { return st; }
+    std::size_t pending() const { return pendingRows; }
+
+    // Appends the CSV text of `s` (newline included) to `out`
+    template <typename RollT, typename CourseCodeT>
+    static void formatRow(std::string &out, const Student<RollT, CourseCodeT> &s) {
+        out += s.getName();
+        out += ',';
+        appendField(out, s.getRoll());
+        out += ',';
+        out += s.getBranch();
+        out += ',';
+        appendField(out, s.getStartYear());
+        out += ',';
+
+        bool first = true;
+        for (const auto &c : s.getCurrentCourses()) {
+            if (!first) out += ';';
+            appendField(out, c);
+            first = false;
+        }
+        out += ',';
+
+        first = true;
+        for (const auto &p : s.getCompletedCourses()) {
+            if (!first) out += ';';
+            appendField(out, p.first);
+            out += ':';
+            appendGrade(out, p.second);
+            first = false;
+        }
+        out += '\n';
+    }
+
+    // Buffers one row; nothing reaches the file before commit(), unless
+    // the buffer outgrows maxBuffer
+    template <typename RollT, typename CourseCodeT>
+    bool append(const Student<RollT, CourseCodeT> &s) {
+        formatRow(buffer, s);
+        ++pendingRows;
+        ++st.rows;
+        return buffer.size() < opts.maxBuffer || commit();
+    }
+
+    // Writes every buffered row in one write() (prefixed by the header
+    // when the file is empty) and syncs as the durability mode asks
+    bool commit() {
+        if (fd < 0) return false;
+        if (buffer.empty()) return true;
+
+        struct stat sb {};
+        if (::fstat(fd, &sb) == 0 && sb.st_size == 0) buffer.insert(0, HEADER);
+
+        bool ok = writeAll(buffer.data(), buffer.size());
+        buffer.clear();
+        pendingRows = 0;
+        ++st.commits;
+        dirty = true;
+
+        if (opts.durability == Durability::PerBatch ||
+            Clock::now() - lastSync >= opts.interval)
+            ok = sync() && ok;
+        return ok;
+    }
+
+    // Forces written rows to stable storage
+    bool sync() {
+        if (fd < 0) return false;
+        if (!dirty) return true;
+        const bool ok = ::fdatasync(fd) == 0;
+        ++st.syncs;
+        dirty = false;
+        lastSync = Clock::now();
+        return ok;
+    }
+
+    // Edits the file itself (after an edit / delete): the first data row
+    // with roll field `roll` that isRow(line) accepts becomes
+    // `replacement`, or is dropped when that is null. Pass the loaders'
+    // row check, so the line edited is the one a load turned into the
+    // in-memory record, not an earlier rejected line with the same roll.
+    // Every other line is copied byte for byte, so rows that were never
+    // loaded survive. The new file replaces the old atomically. False if
+    // no row matches or the file was not replaced; the file is then
+    // unchanged and the log still usable.
+    template <typename RollT, typename CourseCodeT, typename IsRow>
+    bool rewriteRow(std::string_view roll, const Student<RollT, CourseCodeT> *replacement,
+                    IsRow isRow) {
+        if (fd < 0 || !commit() || !sync()) return false;
+        MappedFile file(path);
+        if (!file.isOpen()) return false;
+
+        std::string content;
+        content.reserve(file.size() + 256);
+        const std::string_view text = file.view();
+        std::string_view rest = text;
+        bool header = true, found = false;
+        while (!rest.empty()) {
+            const std::string_view line = popLine(rest);
+            const bool hasNewline = line.data() + line.size() != text.data() + text.size();
+
+            std::string_view name, rowRoll;
+            FieldCursor fields(line);
+            if (!found && !header && fields.next(',', name) && fields.next(',', rowRoll) &&
+                trimView(rowRoll) == roll && isRow(line)) {
+                found = true;
+                if (replacement) formatRow(content, *replacement);
+                continue;
+            }
+            if (!line.empty()) header = false;
+            content += line;
+            if (hasNewline) content += '\n';
+        }
+        return found && replaceFile(content);
+    }
+
+    // Empties the file (no header)
+    bool truncate() {
+        buffer.clear();
+        pendingRows = 0;
+        if (fd < 0 || ::ftruncate(fd, 0) != 0) return false;
+        dirty = true;
+        return sync();
+    }
+};
+
+#endif // CSV_LOG_HPP
@@ -0,0 +1,149 @@
+#ifndef CSV_PARSE_HPP
+#define CSV_PARSE_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <type_traits>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// ========================
+// Allocation-free CSV helpers
+// Fields are string_view slices of the input; numbers are parsed with
+// std::from_chars. Only the final Student objects allocate.
+// ========================
+
+inline bool isSpaceChar(char c) {
+    return c == ' ' || c == '\t' || c == '\n' ||
+           c == '\r' || c == '\f' || c == '\v';
+}
+
+inline std::string_view trimView(std::string_view s) {
+    while (!s.empty() && isSpaceChar(s.front())) s.remove_prefix(1);
+    while (!s.empty() && isSpaceChar(s.back()))  s.remove_suffix(1);
+    return s;
+}
+
+// Walks the delimited fields of one line. Mirrors std::getline on a
+// stringstream: a field is available while unread characters remain, so
+// "a,b," yields "a" and "b" but no third field.
+class FieldCursor {
+private:
+    std::string_view text;
+    std::size_t pos = 0;
+
+public:
+    explicit FieldCursor(std::string_view text) : text(text) {}
+
+    bool next(char delim, std::string_view &out) {
+        if (pos >= text.size()) return false;
+
+        std::size_t end = text.find(delim, pos);
+        if (end == std::string_view::npos) {
+            out = text.substr(pos);
+            pos = text.size();
+        } else {
+            out = text.substr(pos, end - pos);
+            pos = end + 1;
+        }
+        return true;
+    }
+};
+
+// Removes and returns the next line (without its '\n') from `rest`.
+inline std::string_view popLine(std::string_view &rest) {
+    std::size_t eol = rest.find('\n');
+    std::string_view line = rest.substr(0, eol);
+    rest.remove_prefix(eol == std::string_view::npos ? rest.size() : eol + 1);
+    return line;
+}
+
+// Returns everything after the header (the first non-empty line).
+inline std::string_view skipHeaderLine(std::string_view text) {
+    while (!text.empty()) {
+        if (!popLine(text).empty()) break;
+    }
+    return text;
+}
+
+// Splits `text` into at most `parts` consecutive ranges whose boundaries
+// fall just after a '\n', so that no line straddles two ranges.
+inline std::vector<std::string_view>
+splitAtLineBoundaries(std::string_view text, std::size_t parts) {
+    std::vector<std::string_view> chunks;
+    if (parts == 0) parts = 1;
+
+    std::size_t approx = text.size() / parts;
+    std::size_t start = 0;
+
+    for (std::size_t i = 0; i < parts && start < text.size(); ++i) {
+        std::size_t end = text.size();
+        if (i + 1 < parts) {
+            std::size_t target = std::max(start, (i + 1) * approx);
+            std::size_t eol = text.find('\n', target);
+            end = (eol == std::string_view::npos) ? text.size() : eol + 1;
+        }
+        chunks.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return chunks;
+}
+
+// Parses a whole arithmetic field; returns false on malformed or
+// out-of-range input, or trailing characters after the number ("9.5x").
+template <typename T>
+bool parseNumber(std::string_view s, T &out) {
+    if (s.empty()) return false;
+    const char *end = s.data() + s.size();
+    auto res = std::from_chars(s.data(), end, out);
+    return res.ec == std::errc() && res.ptr == end;
+}
+
+// ========================
+// CSV number fields
+// Every CSV loader (loadFromCSV, loadFromCSVMapped, loadFromCSVParallel)
+// reads start years and grades through these two, so all of them accept
+// the same rows. The rules are the ones std::stoi / std::stod applied in
+// the original loader to a trimmed field: an optional sign, a number,
+// and anything after the number ignored ("+2021", "2021.0" and "9.5x"
+// read as 2021, 2021 and 9.5). Out-of-range values fail, and so do
+// non-finite grades. parseNumber() above is the strict whole-field form
+// used for commands and queries.
+// ========================
+
+template <typename T>
+bool parseLeadingNumber(std::string_view s, T &out) {
+    if (s.size() > 1 && s[0] == '+' && s[1] != '+' && s[1] != '-') s.remove_prefix(1);
+    if (s.empty()) return false;
+    auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+    return res.ec == std::errc();
+}
+
+inline bool parseYearField(std::string_view s, int &out) {
+    return parseLeadingNumber(s, out);
+}
+
+inline bool parseGradeField(std::string_view s, double &out) {
+    return parseLeadingNumber(s, out) && std::isfinite(out);
+}
+
+// Converts a field to a roll/course key: strings are copied, integral
+// keys are parsed in place.
+template <typename KeyT>
+bool parseKey(std::string_view s, KeyT &out) {
+    if constexpr (std::is_same<KeyT, std::string>::value) {
+        out.assign(s.data(), s.size());
+        return true;
+    } else if constexpr (std::is_integral<KeyT>::value) {
+        return parseNumber(s, out);
+    } else {
+        static_assert(std::is_integral<KeyT>::value,
+                      "Key type must be std::string or integral");
+        return false;
+    }
+}
+
+#endif // CSV_PARSE_HPP
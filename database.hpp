@@ -1,315 +1,1153 @@
-#ifndef DATABASE_HPP
-#define DATABASE_HPP
-
-#include "student.hpp"
-
-#include <vector>
-#include <unordered_map>
-#include <map>
-#include <string>
-#include <numeric>
-#include <algorithm>
-#include <thread>
-#include <chrono>
-#include <fstream>
-#include <sstream>
-#include <type_traits>
-#include <functional>
-#include <iostream>
-#include <cctype>
-
-// ========================
-// StudentDatabase (Q3–Q5)
-// ========================
-
-template <typename RollT, typename CourseCodeT>
-class StudentDatabase {
-public:
-    using StudentT = Student<RollT, CourseCodeT>;
-
-private:
-    std::vector<StudentT>  students;         // original order
-    std::vector<size_t>    sortedIndices;    // index view for sorted order
-    std::vector<long long> threadTimesMs;    // time taken by each sorting thread
-
-    using GradeIndex =
-        std::unordered_map<CourseCodeT,
-                           std::multimap<double, size_t, std::greater<double>>>;
-
-    GradeIndex gradeIndex;
-
-public:
-    // Add a student directly
-    void addStudent(const StudentT &s) {
-        students.push_back(s);
-    }
-
-    const std::vector<StudentT> &getStudents() const {
-        return students;
-    }
-
-    // ========================
-    // CSV loading (with courses & grades)
-    // CSV format:
-    // name,roll,branch,startYear,currentCourses,completedCourses
-    // currentCourses:  "oopd;ml"
-    // completedCourses:"12345:9.8;ga:7.0"
-    // ========================
-    bool loadFromCSV(const std::string &filename) {
-        std::ifstream file(filename);
-        if (!file) {
-            std::cerr << "Could not open CSV file: " << filename << "\n";
-            return false;
-        }
-
-        std::string line;
-        bool firstLine = true;
-
-        // Optional: start fresh each time you load
-        students.clear();
-
-        auto trim = [](std::string &s) {
-            while (!s.empty() &&
-                   std::isspace(static_cast<unsigned char>(s.front())))
-                s.erase(s.begin());
-            while (!s.empty() &&
-                   std::isspace(static_cast<unsigned char>(s.back())))
-                s.pop_back();
-        };
-
-        while (std::getline(file, line)) {
-            if (line.empty()) continue;
-
-            if (firstLine) {   // header
-                firstLine = false;
-                continue;
-            }
-
-            std::stringstream ss(line);
-            std::string name, rollStr, branch, yearStr, currentStr, completedStr;
-
-            if (!std::getline(ss, name, ','))        continue;
-            if (!std::getline(ss, rollStr, ','))     continue;
-            if (!std::getline(ss, branch, ','))      continue;
-            if (!std::getline(ss, yearStr, ','))     continue;
-            if (!std::getline(ss, currentStr, ','))  currentStr.clear();
-            if (!std::getline(ss, completedStr, ',')) completedStr.clear();
-
-            trim(name);
-            trim(rollStr);
-            trim(branch);
-            trim(yearStr);
-            trim(currentStr);
-            trim(completedStr);
-
-            try {
-                int startYear = std::stoi(yearStr);
-
-                RollT rollValue{};
-                if constexpr (std::is_same<RollT, std::string>::value) {
-                    rollValue = rollStr;
-                } else if constexpr (std::is_integral<RollT>::value) {
-                    rollValue = static_cast<RollT>(std::stoull(rollStr));
-                }
-
-                StudentT s(name, rollValue, branch, startYear);
-
-                // Parse current courses: "oopd;ml"
-                if (!currentStr.empty()) {
-                    std::stringstream cc(currentStr);
-                    std::string token;
-                    while (std::getline(cc, token, ';')) {
-                        trim(token);
-                        if (!token.empty()) {
-                            s.enrollInCourse(token);
-                        }
-                    }
-                }
-
-                // Parse completed: "12345:9.8;ga:7.0"
-                if (!completedStr.empty()) {
-                    std::stringstream cm(completedStr);
-                    std::string token;
-                    while (std::getline(cm, token, ';')) {
-                        trim(token);
-                        if (token.empty()) continue;
-
-                        auto pos = token.find(':');
-                        if (pos == std::string::npos) continue;
-
-                        std::string course   = token.substr(0, pos);
-                        std::string gradeStr = token.substr(pos + 1);
-                        trim(course);
-                        trim(gradeStr);
-
-                        double grade = std::stod(gradeStr);
-                        s.completeCourse(course, grade);
-                    }
-                }
-
-                students.push_back(s);
-            }
-            catch (const std::exception &e) {
-                std::cerr << "Skipping invalid CSV row: '" << line
-                          << "' (" << e.what() << ")\n";
-            }
-        }
-
-        return true;
-    }
-
-    // ========================
-    // Parallel sort by roll
-    // ========================
-    void parallelSortByRoll(std::size_t numThreads = 2) {
-        const std::size_t n = students.size();
-        if (n == 0) {
-            std::cerr << "No students to sort.\n";
-            return;
-        }
-
-        sortedIndices.resize(n);
-        std::iota(sortedIndices.begin(), sortedIndices.end(), 0);
-
-        // Enforce at least 2 threads (assignment requirement)
-        if (numThreads < 2) numThreads = 2;
-        if (numThreads > n) numThreads = n;
-        if (numThreads == 0) numThreads = 1;
-
-        threadTimesMs.assign(numThreads, 0);
-
-        std::vector<std::thread> threads;
-        threads.reserve(numThreads);
-
-        std::vector<std::pair<std::size_t, std::size_t>> segments;
-        segments.reserve(numThreads);
-
-        std::size_t baseSize = n / numThreads;
-        std::size_t remainder = n % numThreads;
-        std::size_t start = 0;
-
-        for (std::size_t i = 0; i < numThreads; ++i) {
-            std::size_t blockSize = baseSize + (i < remainder ? 1 : 0);
-            std::size_t end = start + blockSize;
-            segments.emplace_back(start, end);
-            start = end;
-        }
-
-        auto comp = [this](std::size_t a, std::size_t b) {
-            return students[a].getRoll() < students[b].getRoll();
-        };
-
-        for (std::size_t i = 0; i < numThreads; ++i) {
-            auto [segStart, segEnd] = segments[i];
-
-            threads.emplace_back([this, i, segStart, segEnd, comp]() {
-                auto tStart = std::chrono::high_resolution_clock::now();
-
-                std::sort(sortedIndices.begin() + segStart,
-                          sortedIndices.begin() + segEnd,
-                          comp);
-
-                auto tEnd = std::chrono::high_resolution_clock::now();
-                threadTimesMs[i] =
-                    std::chrono::duration_cast<std::chrono::microseconds>(
-                        tEnd - tStart).count();
-            });
-        }
-
-        for (auto &t : threads) t.join();
-
-        std::size_t currentStart = segments[0].first;
-        std::size_t currentEnd   = segments[0].second;
-
-        for (std::size_t i = 1; i < segments.size(); ++i) {
-            std::size_t nextStart = segments[i].first;
-            std::size_t nextEnd   = segments[i].second;
-
-            std::inplace_merge(sortedIndices.begin() + currentStart,
-                               sortedIndices.begin() + nextStart,
-                               sortedIndices.begin() + nextEnd,
-                               comp);
-
-            currentEnd = nextEnd;
-        }
-
-        std::cout << "\nThread timing (parallel sort, " << numThreads
-                  << " threads used):\n";
-        for (std::size_t i = 0; i < numThreads; ++i) {
-            auto [segStart, segEnd] = segments[i];
-            std::cout << "  Thread " << i << " sorted block ["
-                      << segStart << ", " << segEnd << ") in "
-                      << threadTimesMs[i] << " microseconds\n";
-        }
-    }
-
-    // ========================
-    // Display functions
-    // ========================
-    void printStudentDetailed(const StudentT &s) const {
-        std::cout << s << "\n";
-
-        const auto &current = s.getCurrentCourses();
-        if (!current.empty()) {
-            std::cout << "    Current: ";
-            for (const auto &c : current) std::cout << c << " ";
-            std::cout << "\n";
-        }
-
-        const auto &completed = s.getCompletedCourses();
-        if (!completed.empty()) {
-            std::cout << "    Completed: ";
-            for (const auto &p : completed)
-                std::cout << "(" << p.first << ", grade=" << p.second << ") ";
-            std::cout << "\n";
-        }
-    }
-
-    void showOriginalOrder() const {
-        std::cout << "\n=== Original order of records ===\n";
-        for (const auto &s : students) {
-            printStudentDetailed(s);
-        }
-    }
-
-    void showSortedOrder() const {
-        if (sortedIndices.empty()) {
-            std::cout << "\nSorted indices empty. Call parallelSortByRoll() first.\n";
-            return;
-        }
-
-        std::cout << "\n=== Sorted order by roll ===\n";
-        for (auto idx : sortedIndices) {
-            printStudentDetailed(students[idx]);
-        }
-    }
-
-    // ========================
-    // Grade-based query
-    // ========================
-    void buildGradeIndex() {
-        gradeIndex.clear();
-        for (std::size_t i = 0; i < students.size(); ++i) {
-            const auto &completed = students[i].getCompletedCourses();
-            for (const auto &p : completed) {
-                gradeIndex[p.first].emplace(p.second, i);
-            }
-        }
-    }
-
-    std::vector<const StudentT *>
-    queryByCourseAndMinGrade(const CourseCodeT &course,
-                             double minGrade = 9.0) const {
-        std::vector<const StudentT *> result;
-        auto it = gradeIndex.find(course);
-        if (it == gradeIndex.end()) return result;
-
-        for (const auto &entry : it->second) {
-            if (entry.first < minGrade) break;
-            result.push_back(&students[entry.second]);
-        }
-        return result;
-    }
-};
-
-#endif // DATABASE_HPP
+#ifndef DATABASE_HPP
+#define DATABASE_HPP
+
+#include "student.hpp"
+#include "csv_parse.hpp"
+#include "mapped_file.hpp"
+#include "snapshot.hpp"
+#include "column_store.hpp"
+#include "parallel_sort.hpp"
+#include "thread_pool.hpp"
+#include "grade_index.hpp"
+#include "roll_index.hpp"
+#include "enrollment_index.hpp"
+#include "query.hpp"
+#include "grade_stats.hpp"
+#include "group_by.hpp"
+#include "arena_vector.hpp"
+#include "record_writer.hpp"
+#include "metrics.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <string>
+#include <numeric>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+#include <functional>
+#include <stdexcept>
+#include <iostream>
+#include <cctype>
+#include <string_view>
+#include <cstdint>
+
+// Throughput of the most recent CSV load
+struct LoadStats {
+    std::size_t rowsLoaded  = 0;
+    std::size_t rowsSkipped = 0;
+    double      seconds     = 0.0;
+
+    double rowsPerSecond() const {
+        return seconds > 0.0 ? static_cast<double>(rowsLoaded) / seconds : 0.0;
+    }
+};
+
+inline std::ostream &operator<<(std::ostream &os, const LoadStats &st) {
+    os << st.rowsLoaded << " rows in " << st.seconds * 1000.0 << " ms ("
+       << static_cast<long long>(st.rowsPerSecond()) << " rows/s";
+    if (st.rowsSkipped) os << ", " << st.rowsSkipped << " skipped";
+    os << ")";
+    return os;
+}
+
+// Where loadWithSnapshot() took its records from
+enum class LoadSource { Failed, Snapshot, CSV };
+
+// ========================
+// StudentDatabase (Q3–Q5)
+// ========================
+
+template <typename RollT, typename CourseCodeT>
+class StudentDatabase {
+public:
+    using RollType       = RollT;
+    using CourseCodeType = CourseCodeT;
+    using StudentT     = Student<RollT, CourseCodeT>;
+    using ColumnStoreT = ColumnStore<RollT, CourseCodeT>;
+    using QueryT       = Query<RollT, CourseCodeT>;
+    using KeyTraits    = CourseKeyTraits<CourseCodeT>;
+    using CourseKey    = typename KeyTraits::Key;
+    using GroupRowT    = GroupRow<CourseKey>;
+    using Allocator    = typename StudentT::allocator_type;
+
+private:
+    ArenaVector<StudentT>  students;         // original order
+    std::vector<size_t>    sortedIndices;    // index view for sorted order
+    SortTimings            sortTimings;      // per-phase timings of the last sort
+
+    GradeIndex<CourseKey> gradeIndex;
+    EnrollmentIndex<CourseCodeT> enrollment;   // course -> student bitmaps
+    LoadStats  lastLoad;
+
+    // Primary key on roll: hashed, or direct-addressed for compact
+    // integral rolls (see roll_index.hpp). Removed students stay in
+    // `students` as tombstones, so row numbers held by the grade index and
+    // the sorted view stay valid; compact() drops them.
+    RollIndexFor<RollT> rollIndex;
+    std::vector<bool> removed;          // one flag per row of `students`
+    std::size_t       removedCount = 0;
+
+    // Columnar copy of `students`, built on first use and kept in step
+    // with addStudent(); any reload invalidates it. Built lazily even by
+    // const readers, so a database shared between threads must be
+    // freeze()d first.
+    mutable ColumnStoreT columns;
+    mutable bool         columnsFresh = false;
+
+    // Shared worker pool for sorting, loading, index builds and scans.
+    // Created on first use unless one is injected with setThreadPool().
+    mutable std::shared_ptr<ThreadPool> pool;
+
+    // Loaders build records in per-load arenas owned by `students`
+    bool useArenas = true;
+
+    // Allocator for records of a new load: a fresh arena of about
+    // `sizeHint` bytes, or the default heap when arenas are off
+    Allocator loadAllocator(ArenaVector<StudentT> &owner, std::size_t sizeHint) {
+        if (!useArenas) return Allocator();
+        return Allocator(owner.newArena(sizeHint));
+    }
+
+    void invalidateColumns() {
+        columns.clear();
+        columnsFresh = false;
+    }
+
+    // Stamps lastLoad with the elapsed time and records the load metrics
+    void finishLoad(std::chrono::steady_clock::time_point tStart) {
+        const auto elapsed = std::chrono::steady_clock::now() - tStart;
+        lastLoad.seconds = std::chrono::duration<double>(elapsed).count();
+        Metrics::observe(Timer::Load, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        Metrics::add(Counter::RowsParsed, lastLoad.rowsLoaded);
+        Metrics::add(Counter::RowsRejected, lastLoad.rowsSkipped);
+    }
+
+    // Secondary structures after `students` was replaced wholesale
+    void rebuildIndexes() {
+        removed.assign(students.size(), false);
+        removedCount = 0;
+        sortedIndices.clear();
+        invalidateColumns();
+        buildRollIndex();
+        buildGradeIndex();
+        enrollment.build(students, getThreadPool());
+    }
+
+    void buildRollIndex() {
+        rollIndex.build(students.size(),
+                        [this](std::size_t i) -> const RollT & { return students[i].getRoll(); });
+    }
+
+    // Adds / removes row i in the course-keyed indexes (grades and
+    // enrollment); unindexRow() must see the record as it was indexed
+    void indexRow(std::size_t i) {
+        for (const auto &p : students[i].getCompletedCourseKeys())
+            gradeIndex.insert(p.first, p.second, i);
+        enrollment.add(students[i], i);
+    }
+
+    void unindexRow(std::size_t i) {
+        for (const auto &p : students[i].getCompletedCourseKeys())
+            gradeIndex.erase(p.first, p.second, i);
+        enrollment.remove(students[i], i);
+    }
+
+    // Grade stats of each array; every array is cut into pieces of at
+    // most 64K grades and all pieces are summarised on the pool
+    std::vector<GradeStats>
+    summarise(const std::vector<const std::vector<double> *> &arrays) const {
+        struct Piece { std::size_t array, first, last; };
+        const std::size_t pieceSize = 64 * 1024;
+
+        std::vector<Piece> pieces;
+        for (std::size_t a = 0; a < arrays.size(); ++a)
+            for (std::size_t f = 0; f < arrays[a]->size(); f += pieceSize)
+                pieces.push_back({a, f, std::min(arrays[a]->size(), f + pieceSize)});
+
+        std::vector<GradeStats> partial(pieces.size());
+        getThreadPool().parallelFor(pieces.size(), [&](std::size_t p) {
+            const double *g = arrays[pieces[p].array]->data();
+            partial[p] = computeGradeStats(g + pieces[p].first,
+                                           pieces[p].last - pieces[p].first);
+        });
+
+        std::vector<GradeStats> out(arrays.size());
+        for (std::size_t p = 0; p < pieces.size(); ++p)
+            out[pieces[p].array].merge(partial[p]);
+        return out;
+    }
+
+    // Position of row `i` in sortedIndices, or NOT_FOUND
+    std::size_t sortedPosition(std::size_t i) const {
+        const RollT &roll = students[i].getRoll();
+        auto first = std::lower_bound(
+            sortedIndices.begin(), sortedIndices.end(), roll,
+            [this](std::size_t idx, const RollT &r) { return students[idx].getRoll() < r; });
+        for (auto it = first; it != sortedIndices.end() &&
+                              !(roll < students[*it].getRoll()); ++it)
+            if (*it == i) return static_cast<std::size_t>(it - sortedIndices.begin());
+        return NOT_FOUND;
+    }
+
+    void insertSorted(std::size_t i) {
+        auto pos = std::upper_bound(
+            sortedIndices.begin(), sortedIndices.end(), students[i].getRoll(),
+            [this](const RollT &r, std::size_t idx) { return r < students[idx].getRoll(); });
+        sortedIndices.insert(pos, i);
+    }
+
+    // Outcome of parsing one data row. Rows missing one of the four
+    // mandatory fields are ignored silently, as loadFromCSV() does.
+    enum class RowStatus { Ok, Incomplete, Invalid };
+
+    // The six fields of a data row, trimmed
+    struct CSVRowFields {
+        std::string_view name, roll, branch, year, current, completed;
+    };
+
+    // Splits a data row; false if one of the four mandatory fields is
+    // missing
+    static bool splitCSVRow(std::string_view line, CSVRowFields &f) {
+        FieldCursor fields(line);
+        if (!fields.next(',', f.name) || !fields.next(',', f.roll) ||
+            !fields.next(',', f.branch) || !fields.next(',', f.year)) {
+            return false;
+        }
+        fields.next(',', f.current);
+        fields.next(',', f.completed);
+        for (auto *v : {&f.name, &f.roll, &f.branch, &f.year, &f.current, &f.completed})
+            *v = trimView(*v);
+        return true;
+    }
+
+    // Builds one Student from a data row (header already skipped) in
+    // place at the end of `out`, allocating from `alloc`.
+    static RowStatus parseCSVRow(std::string_view line, std::vector<StudentT> &out,
+                                 const Allocator &alloc) {
+        CSVRowFields f;
+        if (!splitCSVRow(line, f)) return RowStatus::Incomplete;
+
+        int startYear;
+        RollT rollValue{};
+        if (!parseYearField(f.year, startYear) || !parseKey(f.roll, rollValue))
+            return RowStatus::Invalid;
+
+        StudentT &s = out.emplace_back(f.name, rollValue, branchSymbols().intern(f.branch),
+                                       startYear, alloc);
+        auto reject = [&out] {
+            out.pop_back();
+            return RowStatus::Invalid;
+        };
+
+        // Parse current courses: "oopd;ml"
+        FieldCursor cc(f.current);
+        std::string_view token;
+        while (cc.next(';', token)) {
+            token = trimView(token);
+            if (token.empty()) continue;
+
+            CourseKey course;
+            if (!KeyTraits::parse(token, course)) return reject();
+            s.enrollInCourseKey(course);
+        }
+
+        // Parse completed: "12345:9.8;ga:7.0"
+        FieldCursor cm(f.completed);
+        while (cm.next(';', token)) {
+            token = trimView(token);
+            if (token.empty()) continue;
+
+            auto pos = token.find(':');
+            if (pos == std::string_view::npos) continue;
+
+            CourseKey course;
+            double grade;
+            if (!KeyTraits::parse(trimView(token.substr(0, pos)), course) ||
+                !parseGradeField(trimView(token.substr(pos + 1)), grade)) {
+                return reject();
+            }
+            s.completeCourseKey(course, grade);
+        }
+        return RowStatus::Ok;
+    }
+
+    // Parses every data line of `text` into `out`. Malformed rows are
+    // counted and collected (not printed) so callers on worker threads
+    // can report them in file order afterwards.
+    void parseCSVRange(std::string_view text,
+                       std::vector<StudentT> &out,
+                       const Allocator &alloc,
+                       LoadStats &stats,
+                       std::vector<std::string_view> &badRows) const {
+        while (!text.empty()) {
+            std::string_view line = popLine(text);
+            if (line.empty()) continue;
+
+            switch (parseCSVRow(line, out, alloc)) {
+            case RowStatus::Ok:
+                ++stats.rowsLoaded;
+                break;
+            case RowStatus::Invalid:
+                badRows.push_back(line);
+                ++stats.rowsSkipped;
+                break;
+            case RowStatus::Incomplete:
+                break;
+            }
+        }
+    }
+
+    static void reportBadRows(const std::vector<std::string_view> &badRows) {
+        for (auto line : badRows)
+            std::cerr << "Skipping invalid CSV row: '" << line << "'\n";
+    }
+
+public:
+    // Whether the loaders would accept `line` as a data row. Unlike a
+    // load it builds nothing and interns no branch or course code.
+    static bool isValidCSVRow(std::string_view line) {
+        CSVRowFields f;
+        int startYear;
+        RollT rollValue{};
+        if (!splitCSVRow(line, f) || !parseYearField(f.year, startYear) ||
+            !parseKey(f.roll, rollValue)) {
+            return false;
+        }
+
+        FieldCursor cc(f.current);
+        std::string_view token;
+        while (cc.next(';', token)) {
+            token = trimView(token);
+            if (!token.empty() && !KeyTraits::valid(token)) return false;
+        }
+
+        FieldCursor cm(f.completed);
+        while (cm.next(';', token)) {
+            token = trimView(token);
+            const auto pos = token.find(':');
+            if (pos == std::string_view::npos) continue;
+
+            double grade;
+            if (!KeyTraits::valid(trimView(token.substr(0, pos))) ||
+                !parseGradeField(trimView(token.substr(pos + 1)), grade)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr std::size_t NOT_FOUND = RollIndexFor<RollT>::NONE;
+
+    // Add a student directly; the roll, grade and enrollment indexes and
+    // the sorted view (once built) are patched in place
+    void addStudent(const StudentT &s) {
+        students.push_back(s);
+        removed.push_back(false);
+        const std::size_t i = students.size() - 1;
+        if (columnsFresh) columns.append(s, i);
+
+        rollIndex.insert(s.getRoll(), i);
+        indexRow(i);
+        if (!sortedIndices.empty()) insertSorted(i);
+    }
+
+    // Records a completed course for students[studentIndex] and patches
+    // the grade and enrollment indexes (replacing the old grade if the
+    // course was already graded). Use this rather than
+    // Student::completeCourse() on a copy. False if the row does not
+    // exist or was removed; a removed row must stay out of the indexes.
+    bool completeCourse(std::size_t studentIndex, const CourseCodeT &course,
+                        double grade) {
+        if (studentIndex >= students.size() || removed[studentIndex]) return false;
+        StudentT &s = students[studentIndex];
+        const CourseKey key = KeyTraits::intern(course);
+
+        if (const double *old = s.findGrade(key))
+            gradeIndex.erase(key, *old, studentIndex);
+        enrollment.remove(s, studentIndex);
+
+        s.completeCourseKey(key, grade);
+        gradeIndex.insert(key, grade, studentIndex);
+        enrollment.add(s, studentIndex);
+        invalidateColumns();
+        return true;
+    }
+
+    // All rows, including removed ones; check isRemoved() when walking
+    // this after removeStudent()
+    const std::vector<StudentT> &getStudents() const {
+        return students;
+    }
+
+    bool isRemoved(std::size_t i) const { return removed[i]; }
+    std::size_t liveCount() const { return students.size() - removedCount; }
+    std::size_t removedRows() const { return removedCount; }
+
+    // ========================
+    // Primary key (roll)
+    // Hash lookups, O(1) expected. Edits and deletes patch the grade
+    // index and the sorted view in place instead of rebuilding them.
+    // ========================
+
+    // Row of the live student with this roll (the first loaded if the
+    // roll is duplicated), or NOT_FOUND
+    std::size_t findRowByRoll(const RollT &roll) const {
+        ScopedTimer timer(Timer::RollLookup);
+        std::size_t row = rollIndex.find(roll, [this](std::size_t i) -> const RollT & {
+            return students[i].getRoll();
+        });
+        if (row != NOT_FOUND) Metrics::add(Counter::QueryHits);
+        return row;
+    }
+
+    const StudentT *findByRoll(const RollT &roll) const {
+        std::size_t i = findRowByRoll(roll);
+        return i == NOT_FOUND ? nullptr : &students[i];
+    }
+
+    // Calls fn(row) for every live row with this roll, in no set order
+    template <typename Fn>
+    void forEachRowWithRoll(const RollT &roll, Fn fn) const {
+        rollIndex.forEachMatch(
+            roll, [this](std::size_t i) -> const RollT & { return students[i].getRoll(); },
+            fn);
+    }
+
+    // Replaces the record for `roll` with `updated` (which may carry a
+    // new roll). False if no live student has `roll`.
+    bool updateStudent(const RollT &roll, const StudentT &updated) {
+        const std::size_t i = findRowByRoll(roll);
+        if (i == NOT_FOUND) return false;
+
+        const bool rollChanged = !(updated.getRoll() == roll);
+        std::size_t sortedPos = NOT_FOUND;
+        if (rollChanged) {
+            sortedPos = sortedPosition(i);
+            rollIndex.erase(roll, i);
+        }
+        unindexRow(i);
+
+        students[i] = updated;
+
+        indexRow(i);
+        if (rollChanged) {
+            rollIndex.insert(updated.getRoll(), i);
+            if (sortedPos != NOT_FOUND) {
+                sortedIndices.erase(sortedIndices.begin() + sortedPos);
+                insertSorted(i);
+            }
+        }
+        invalidateColumns();
+        return true;
+    }
+
+    // Tombstones the student with `roll`. The row keeps its number (and
+    // its slot in the sorted view, where it is skipped) until compact().
+    bool removeStudent(const RollT &roll) {
+        const std::size_t i = findRowByRoll(roll);
+        if (i == NOT_FOUND) return false;
+
+        rollIndex.erase(roll, i);
+        unindexRow(i);
+        removed[i] = true;
+        ++removedCount;
+        invalidateColumns();
+        return true;
+    }
+
+    // Drops tombstoned rows. Row numbers change, so every index is
+    // rebuilt; the sorted view is carried over (renumbered), not re-sorted.
+    void compact() {
+        if (removedCount == 0) return;
+
+        std::vector<std::size_t> newRow(students.size(), NOT_FOUND);
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < students.size(); ++i) {
+            if (removed[i]) continue;
+            newRow[i] = next;
+            if (next != i) students[next] = std::move(students[i]);
+            ++next;
+        }
+        students.resize(next);
+
+        std::vector<std::size_t> sorted;
+        sorted.reserve(next);
+        for (auto idx : sortedIndices)
+            if (newRow[idx] != NOT_FOUND) sorted.push_back(newRow[idx]);
+
+        rebuildIndexes();
+        sortedIndices.swap(sorted);
+    }
+
+    const LoadStats &getLastLoadStats() const {
+        return lastLoad;
+    }
+
+    // Arena allocation for loaded records (on by default); takes effect
+    // at the next load
+    void setArenaAllocation(bool on) { useArenas = on; }
+    bool arenaAllocation() const { return useArenas; }
+
+    // ========================
+    // Thread pool
+    // ========================
+    ThreadPool &getThreadPool() const {
+        if (!pool) pool = std::make_shared<ThreadPool>();
+        return *pool;
+    }
+
+    // Shares one pool between several databases (or with the caller)
+    void setThreadPool(std::shared_ptr<ThreadPool> p) {
+        pool = std::move(p);
+    }
+
+    // Builds everything the read API would otherwise build lazily (the
+    // pool and the column store). Afterwards const members write nothing,
+    // so any number of threads may read at once while nobody modifies
+    // this database (see versioned_database.hpp).
+    void freeze() const {
+        getThreadPool();
+        getColumns();
+    }
+
+    // Indices of all students matching `pred`, in original order. The
+    // scan is split into chunks evaluated on the pool.
+    template <typename Pred>
+    std::vector<std::size_t> filterIndices(Pred pred) const {
+        const std::size_t n = students.size();
+        const std::size_t chunkSize = 16 * 1024;
+        const std::size_t chunks = (n + chunkSize - 1) / chunkSize;
+
+        std::vector<std::vector<std::size_t>> partial(chunks);
+        getThreadPool().parallelFor(chunks, [&](std::size_t c) {
+            std::size_t end = std::min(n, (c + 1) * chunkSize);
+            for (std::size_t i = c * chunkSize; i < end; ++i)
+                if (!removed[i] && pred(students[i])) partial[c].push_back(i);
+        });
+
+        std::vector<std::size_t> result;
+        for (auto &part : partial)
+            result.insert(result.end(), part.begin(), part.end());
+        return result;
+    }
+
+    // Columnar view of the live records (see column_store.hpp). Column
+    // rows match getStudents() indices only while nothing is removed.
+    const ColumnStoreT &getColumns() const {
+        if (!columnsFresh) {
+            columns.build(students, [this](std::size_t i) { return !removed[i]; });
+            columnsFresh = true;
+        }
+        return columns;
+    }
+
+    // ========================
+    // CSV loading (with courses & grades)
+    // CSV format:
+    // name,roll,branch,startYear,currentCourses,completedCourses
+    // currentCourses:  "oopd;ml"
+    // completedCourses:"12345:9.8;ga:7.0"
+    // ========================
+    bool loadFromCSV(const std::string &filename) {
+        auto tStart = std::chrono::steady_clock::now();
+        lastLoad = LoadStats();
+
+        std::ifstream file(filename, std::ios::ate);
+        if (!file) {
+            std::cerr << "Could not open CSV file: " << filename << "\n";
+            return false;
+        }
+        const auto fileSize = static_cast<std::size_t>(file.tellg());
+        file.seekg(0);
+
+        std::string line;
+        bool firstLine = true;
+
+        // Optional: start fresh each time you load
+        students.reset();
+        invalidateColumns();
+        const Allocator alloc = loadAllocator(students, fileSize);
+
+        auto trim = [](std::string &s) {
+            while (!s.empty() &&
+                   std::isspace(static_cast<unsigned char>(s.front())))
+                s.erase(s.begin());
+            while (!s.empty() &&
+                   std::isspace(static_cast<unsigned char>(s.back())))
+                s.pop_back();
+        };
+
+        while (std::getline(file, line)) {
+            if (line.empty()) continue;
+
+            if (firstLine) {   // header
+                firstLine = false;
+                continue;
+            }
+
+            std::stringstream ss(line);
+            std::string name, rollStr, branch, yearStr, currentStr, completedStr;
+
+            if (!std::getline(ss, name, ','))        continue;
+            if (!std::getline(ss, rollStr, ','))     continue;
+            if (!std::getline(ss, branch, ','))      continue;
+            if (!std::getline(ss, yearStr, ','))     continue;
+            if (!std::getline(ss, currentStr, ','))  currentStr.clear();
+            if (!std::getline(ss, completedStr, ',')) completedStr.clear();
+
+            trim(name);
+            trim(rollStr);
+            trim(branch);
+            trim(yearStr);
+            trim(currentStr);
+            trim(completedStr);
+
+            bool placed = false;
+            try {
+                int startYear;
+                if (!parseYearField(yearStr, startYear))
+                    throw std::invalid_argument("bad start year '" + yearStr + "'");
+
+                RollT rollValue{};
+                if (!parseKey(std::string_view(rollStr), rollValue))
+                    throw std::invalid_argument("bad roll '" + rollStr + "'");
+
+                StudentT &s = students.emplace_back(name, rollValue, branch, startYear, alloc);
+                placed = true;
+
+                // Parse current courses: "oopd;ml"
+                if (!currentStr.empty()) {
+                    std::stringstream cc(currentStr);
+                    std::string token;
+                    while (std::getline(cc, token, ';')) {
+                        trim(token);
+                        if (token.empty()) continue;
+
+                        CourseKey course;
+                        if (!KeyTraits::parse(token, course))
+                            throw std::invalid_argument("bad course code '" + token + "'");
+                        s.enrollInCourseKey(course);
+                    }
+                }
+
+                // Parse completed: "12345:9.8;ga:7.0"
+                if (!completedStr.empty()) {
+                    std::stringstream cm(completedStr);
+                    std::string token;
+                    while (std::getline(cm, token, ';')) {
+                        trim(token);
+                        if (token.empty()) continue;
+
+                        auto pos = token.find(':');
+                        if (pos == std::string::npos) continue;
+
+                        std::string courseStr = token.substr(0, pos);
+                        std::string gradeStr  = token.substr(pos + 1);
+                        trim(courseStr);
+                        trim(gradeStr);
+
+                        CourseKey course;
+                        if (!KeyTraits::parse(courseStr, course))
+                            throw std::invalid_argument("bad course code '" + courseStr + "'");
+                        double grade;
+                        if (!parseGradeField(gradeStr, grade))
+                            throw std::invalid_argument("bad grade '" + gradeStr + "'");
+                        s.completeCourseKey(course, grade);
+                    }
+                }
+
+                ++lastLoad.rowsLoaded;
+            }
+            catch (const std::exception &e) {
+                if (placed) students.pop_back();
+                std::cerr << "Skipping invalid CSV row: '" << line
+                          << "' (" << e.what() << ")\n";
+                ++lastLoad.rowsSkipped;
+            }
+        }
+
+        rebuildIndexes();
+        finishLoad(tStart);
+        return true;
+    }
+
+    // ========================
+    // Memory-mapped CSV loading
+    // Same format and records as loadFromCSV(), but the file is mapped
+    // and parsed in place: no per-line strings or stringstreams.
+    // ========================
+    bool loadFromCSVMapped(const std::string &filename) {
+        auto tStart = std::chrono::steady_clock::now();
+        lastLoad = LoadStats();
+
+        MappedFile file(filename);
+        if (!file.isOpen()) {
+            std::cerr << "Could not open CSV file: " << filename << "\n";
+            return false;
+        }
+
+        students.reset();
+        invalidateColumns();
+
+        std::vector<std::string_view> badRows;
+        parseCSVRange(skipHeaderLine(file.view()), students,
+                      loadAllocator(students, file.size()), lastLoad, badRows);
+        reportBadRows(badRows);
+
+        rebuildIndexes();
+        finishLoad(tStart);
+        return true;
+    }
+
+    // ========================
+    // Parallel chunked CSV loading
+    // The mapped file is split into newline-aligned byte ranges, one pool
+    // task per range. Each task parses its range into a private vector and
+    // the chunks are stitched back in file order, so the original order
+    // of records is the same as with the sequential loaders.
+    // ========================
+    bool loadFromCSVParallel(const std::string &filename,
+                             std::size_t numThreads = 2) {
+        auto tStart = std::chrono::steady_clock::now();
+        lastLoad = LoadStats();
+
+        MappedFile file(filename);
+        if (!file.isOpen()) {
+            std::cerr << "Could not open CSV file: " << filename << "\n";
+            return false;
+        }
+
+        students.reset();
+        invalidateColumns();
+
+        // Very small chunks cost more in thread start-up than they save
+        const std::size_t minChunkBytes = 64 * 1024;
+        std::string_view body = skipHeaderLine(file.view());
+        if (numThreads == 0) numThreads = 1;
+        numThreads = std::min(numThreads, body.size() / minChunkBytes + 1);
+
+        auto chunks = splitAtLineBoundaries(body, numThreads);
+
+        std::vector<std::vector<StudentT>>          parsed(chunks.size());
+        std::vector<LoadStats>                      chunkStats(chunks.size());
+        std::vector<std::vector<std::string_view>>  chunkBad(chunks.size());
+
+        // One arena per chunk: arenas are not shared between threads
+        std::vector<Allocator> allocs;
+        for (auto chunk : chunks) allocs.push_back(loadAllocator(students, chunk.size()));
+
+        ThreadPool &workers = getThreadPool();
+        workers.parallelFor(chunks.size(), [&](std::size_t i) {
+            parseCSVRange(chunks[i], parsed[i], allocs[i], chunkStats[i], chunkBad[i]);
+        });
+
+        // Stitch chunks in file order; each task moves its own chunk
+        // (moved records keep their chunk's arena)
+        std::vector<std::size_t> offsets(parsed.size() + 1, 0);
+        for (std::size_t i = 0; i < parsed.size(); ++i) {
+            offsets[i + 1] = offsets[i] + parsed[i].size();
+            lastLoad.rowsLoaded  += chunkStats[i].rowsLoaded;
+            lastLoad.rowsSkipped += chunkStats[i].rowsSkipped;
+            reportBadRows(chunkBad[i]);
+        }
+
+        students.resize(offsets.back());
+        workers.parallelFor(parsed.size(), [&](std::size_t i) {
+            std::move(parsed[i].begin(), parsed[i].end(),
+                      students.begin() + offsets[i]);
+            std::vector<StudentT>().swap(parsed[i]);
+        });
+
+        rebuildIndexes();
+        finishLoad(tStart);
+        return true;
+    }
+
+    // ========================
+    // Binary snapshots (see snapshot.hpp for the format)
+    // ========================
+    bool saveSnapshot(const std::string &path) const {
+        if (removedCount == 0) return writeSnapshot(path, students);
+
+        std::vector<StudentT> live;
+        live.reserve(liveCount());
+        for (std::size_t i = 0; i < students.size(); ++i)
+            if (!removed[i]) live.push_back(students[i]);
+        return writeSnapshot(path, live);
+    }
+
+    bool loadSnapshot(const std::string &path) {
+        auto tStart = std::chrono::steady_clock::now();
+        lastLoad = LoadStats();
+
+        ArenaVector<StudentT> loaded;
+        const Allocator alloc = loadAllocator(loaded, 0);
+        if (!readSnapshot(path, loaded, alloc.resource())) return false;
+        students = std::move(loaded);
+        invalidateColumns();
+
+        lastLoad.rowsLoaded = students.size();
+        rebuildIndexes();
+        finishLoad(tStart);
+        return true;
+    }
+
+    // Loads from the snapshot when it is at least as new as the CSV;
+    // otherwise parses the CSV and regenerates the snapshot.
+    LoadSource loadWithSnapshot(const std::string &csvPath,
+                                const std::string &snapshotPath,
+                                std::size_t numThreads = 2) {
+        if (snapshotIsFresh(snapshotPath, csvPath) && loadSnapshot(snapshotPath))
+            return LoadSource::Snapshot;
+
+        if (!loadFromCSVParallel(csvPath, numThreads)) return LoadSource::Failed;
+
+        if (!saveSnapshot(snapshotPath))
+            std::cerr << "Warning: snapshot not written: " << snapshotPath << "\n";
+        return LoadSource::CSV;
+    }
+
+    // ========================
+    // Parallel sort by roll
+    // Blocks are sorted in parallel (LSD radix sort when RollT is
+    // integral, std::sort otherwise) and then combined by a parallel
+    // tree merge; see parallel_sort.hpp. Per-phase timings are kept in
+    // getLastSortTimings() and the pool's stats; nothing is printed.
+    // ========================
+    void parallelSortByRoll(std::size_t numThreads = 2) {
+        ScopedTimer timer(Timer::Sort);
+        const std::size_t n = liveCount();
+        if (n == 0) {
+            std::cerr << "No students to sort.\n";
+            return;
+        }
+
+        // Removed rows are left out of the sorted view
+        sortedIndices.clear();
+        sortedIndices.reserve(n);
+        for (std::size_t i = 0; i < students.size(); ++i)
+            if (!removed[i]) sortedIndices.push_back(i);
+
+        // Enforce at least 2 threads (assignment requirement)
+        if (numThreads < 2) numThreads = 2;
+        if (numThreads > n) numThreads = n;
+        if (numThreads == 0) numThreads = 1;
+
+        auto comp = [this](std::size_t a, std::size_t b) {
+            return students[a].getRoll() < students[b].getRoll();
+        };
+
+        constexpr bool useRadix =
+            std::is_integral<RollT>::value && !std::is_same<RollT, bool>::value;
+        sortTimings.radix = useRadix;
+
+        ThreadPool &workers = getThreadPool();
+        workers.resetStats();
+
+        parallelBlockSortMerge(
+            workers, sortedIndices, numThreads, comp,
+            [this, comp](std::size_t *first, std::size_t *last) {
+                if constexpr (useRadix) {
+                    radixSortByKey(first, last, [this](std::size_t idx) {
+                        return radixKey(students[idx].getRoll());
+                    });
+                } else {
+                    std::sort(first, last, comp);
+                }
+            },
+            sortTimings);
+    }
+
+    const SortTimings &getLastSortTimings() const {
+        return sortTimings;
+    }
+
+    // Rows in roll order as of the last parallelSortByRoll() (kept up to
+    // date by later edits); empty if never sorted. May hold removed rows.
+    const std::vector<std::size_t> &getSortedIndices() const {
+        return sortedIndices;
+    }
+
+    // ========================
+    // Display functions
+    // ========================
+    // Accepts a Student or a ColumnStore row view
+    template <typename RecordT>
+    void printStudentDetailed(const RecordT &s) const {
+        std::string text;
+        RecordWriter::format(text, s, OutputFormat::Pretty);
+        std::cout << text;
+    }
+
+    // Bulk listings go through a RecordWriter: one reusable buffer, large
+    // write()s to `fd`, and an optional offset/limit window over the live
+    // records. The banner is only printed for the Pretty format, so TSV
+    // and JSON Lines output stays machine-readable. Returns the number of
+    // records written.
+    std::size_t showOriginalOrder(const OutputOptions &opts = OutputOptions(),
+                                  int fd = STDOUT_FILENO) const {
+        RecordWriter out(fd, opts);
+        if (opts.format == OutputFormat::Pretty)
+            out.text("\n=== Original order of records ===\n");
+        for (std::size_t i = 0; i < students.size(); ++i) {
+            if (!removed[i] && !out.write(students[i])) break;
+        }
+        out.flush();
+        return out.recordsWritten();
+    }
+
+    std::size_t showSortedOrder(const OutputOptions &opts = OutputOptions(),
+                                int fd = STDOUT_FILENO) const {
+        if (sortedIndices.empty()) {
+            std::cout << "\nSorted indices empty. Call parallelSortByRoll() first.\n";
+            return 0;
+        }
+
+        RecordWriter out(fd, opts);
+        if (opts.format == OutputFormat::Pretty)
+            out.text("\n=== Sorted order by roll ===\n");
+        for (auto idx : sortedIndices) {
+            if (!removed[idx] && !out.write(students[idx])) break;
+        }
+        out.flush();
+        return out.recordsWritten();
+    }
+
+    // ========================
+    // Grade-based query
+    // ========================
+    // The index is kept live: loads rebuild it, and addStudent() and
+    // completeCourse() patch it, so queries never need a rebuild first.
+    // This is the explicit bulk rebuild: chunks of students collect
+    // (grade, index) pairs per course on the pool, then every course's
+    // array is sorted in parallel (see grade_index.hpp).
+    void buildGradeIndex() {
+        ScopedTimer timer(Timer::IndexBuild);
+        using Entries = typename GradeIndex<CourseKey>::Entries;
+        const std::size_t n = students.size();
+        const std::size_t chunkSize = 16 * 1024;
+        const std::size_t chunks = (n + chunkSize - 1) / chunkSize;
+
+        ThreadPool &workers = getThreadPool();
+        std::vector<Entries> partial(chunks);
+        workers.parallelFor(chunks, [&](std::size_t c) {
+            std::size_t end = std::min(n, (c + 1) * chunkSize);
+            for (std::size_t i = c * chunkSize; i < end; ++i) {
+                for (const auto &p : students[i].getCompletedCourseKeys())
+                    partial[c][p.first].emplace_back(p.second, i);
+            }
+        });
+
+        Entries entries;
+        std::size_t total = 0;
+        for (auto &part : partial) {
+            part.forEach([&](CourseKey k, auto &pairs) {
+                auto &dst = entries[k];
+                total += pairs.size();
+                if (dst.empty()) dst.swap(pairs);
+                else dst.insert(dst.end(), pairs.begin(), pairs.end());
+            });
+        }
+        Metrics::add(Counter::IndexEntries, total);
+        gradeIndex.build(std::move(entries), workers);
+    }
+
+    using GradeRange = typename GradeIndex<CourseKey>::Range;
+
+    std::vector<const StudentT *>
+    queryByCourseAndMinGrade(const CourseCodeT &course,
+                             double minGrade = 9.0) const {
+        ScopedTimer timer(Timer::GradeQuery);
+        std::vector<const StudentT *> result;
+        for (auto entry : gradeIndex.atLeast(KeyTraits::find(course), minGrade))
+            result.push_back(&students[entry.row]);
+        Metrics::add(Counter::QueryHits, result.size());
+        return result;
+    }
+
+    // Grades in [minGrade, maxGrade] for one course, best first. The range
+    // refers to the index directly (no copy); entry.row indexes
+    // getStudents(). Valid until the database is next modified.
+    GradeRange queryByCourseGradeRange(const CourseCodeT &course,
+                                       double minGrade, double maxGrade) const {
+        ScopedTimer timer(Timer::GradeRangeQuery);
+        GradeRange r = gradeIndex.between(KeyTraits::find(course), minGrade, maxGrade);
+        Metrics::add(Counter::QueryHits, r.size());
+        return r;
+    }
+
+    // The k best grades in one course
+    GradeRange topKByCourse(const CourseCodeT &course, std::size_t k) const {
+        ScopedTimer timer(Timer::TopKQuery);
+        GradeRange r = gradeIndex.topK(KeyTraits::find(course), k);
+        Metrics::add(Counter::QueryHits, r.size());
+        return r;
+    }
+
+    const GradeIndex<CourseKey> &getGradeIndex() const {
+        return gradeIndex;
+    }
+
+    // ========================
+    // Course enrollment filters (bitmap index)
+    // Course codes match case-insensitively. Results are bitmaps of
+    // getStudents() rows; combine them with &, | and andNot().
+    // ========================
+    RowBitmap studentsWithCourse(const CourseCodeT &course,
+                                 CourseRole role = CourseRole::Any) const {
+        ScopedTimer timer(Timer::CourseFilter);
+        const CourseKey folded = KeyTraits::findFolded(course);
+        if (folded == KeyTraits::NONE) return RowBitmap();
+        RowBitmap rows = enrollment.rows(folded, role);
+        if (Metrics::enabled()) Metrics::add(Counter::QueryHits, rows.cardinality());
+        return rows;
+    }
+
+    // Students with every course in `courses`
+    RowBitmap studentsWithAllCourses(const std::vector<CourseCodeT> &courses,
+                                     CourseRole role = CourseRole::Any) const {
+        if (courses.empty()) return RowBitmap();
+        RowBitmap result = studentsWithCourse(courses[0], role);
+        for (std::size_t i = 1; i < courses.size() && !result.empty(); ++i)
+            result &= studentsWithCourse(courses[i], role);
+        return result;
+    }
+
+    // Students with at least one course in `courses`
+    RowBitmap studentsWithAnyCourse(const std::vector<CourseCodeT> &courses,
+                                    CourseRole role = CourseRole::Any) const {
+        RowBitmap result;
+        for (const auto &c : courses) result |= studentsWithCourse(c, role);
+        return result;
+    }
+
+    const EnrollmentIndex<CourseCodeT> &getEnrollmentIndex() const {
+        return enrollment;
+    }
+
+    // ========================
+    // Predicate queries (see query.hpp)
+    // Returns matching rows of getStudents(), ascending. `plan`, if
+    // given, receives the steps the engine chose.
+    // ========================
+    std::vector<std::size_t> select(const QueryT &q,
+                                    std::vector<std::string> *plan = nullptr) const {
+        ScopedTimer timer(Timer::Query);
+        std::vector<std::size_t> rows = QueryEngine<StudentDatabase>(*this, plan).run(q);
+        Metrics::add(Counter::QueryHits, rows.size());
+        return rows;
+    }
+
+    std::vector<std::size_t> select(std::string_view text,
+                                    std::vector<std::string> *plan = nullptr) const {
+        return select(parseQuery<RollT, CourseCodeT>(text), plan);
+    }
+
+    // ========================
+    // Grade analytics (see grade_stats.hpp)
+    // Every statistic comes out of one pass over contiguous grades: the
+    // per-course arrays of the grade index, or the column store's grade
+    // column. Arrays are cut into 64K-grade pieces summarised on the pool
+    // and merged in order, so results do not depend on the thread count.
+    // ========================
+    using CourseStats = std::pair<CourseCodeT, GradeStats>;
+
+    // Stats of every course that has grades, in course-code order
+    std::vector<CourseStats> courseStatistics() const {
+        std::vector<CourseKey> keys;
+        gradeIndex.allCourses().forEach(
+            [&keys](CourseKey k, const auto &) { keys.push_back(k); });
+        std::sort(keys.begin(), keys.end(), KeyTraits::less);
+
+        std::vector<const std::vector<double> *> arrays;
+        for (auto k : keys) arrays.push_back(&gradeIndex.find(k)->grades);
+        std::vector<GradeStats> stats = summarise(arrays);
+
+        std::vector<CourseStats> out;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+            out.emplace_back(KeyTraits::code(keys[i]), stats[i]);
+        return out;
+    }
+
+    GradeStats courseStatistics(const CourseCodeT &course) const {
+        const auto *c = gradeIndex.find(KeyTraits::find(course));
+        if (!c) return GradeStats();
+        return summarise({&c->grades})[0];
+    }
+
+    // Stats over every completed-course grade of every live student
+    GradeStats gradeStatistics() const {
+        return summarise({&getColumns().completedCourseGrades()})[0];
+    }
+
+    // Mean grade over one student's completed courses (0 if none)
+    double cgpa(std::size_t row) const {
+        const auto &done = students.at(row).getCompletedCourseKeys();
+        if (done.empty()) return 0.0;
+        double sum = 0.0;
+        for (const auto &p : done) sum += p.second;
+        return sum / static_cast<double>(done.size());
+    }
+
+    // CGPA of every row of getStudents() (0 for removed rows and for
+    // students with no completed courses), from the column store's CSR
+    // grade column in parallel chunks
+    std::vector<double> allCgpa() const {
+        const auto &cols    = getColumns();
+        const auto &offsets = cols.completedCourseOffsets();
+        const auto &grades  = cols.completedCourseGrades();
+        const auto &source  = cols.sourceRows();
+
+        std::vector<double> out(students.size(), 0.0);
+        const std::size_t n = cols.size();
+        const std::size_t chunkSize = 16 * 1024;
+        const std::size_t chunks = (n + chunkSize - 1) / chunkSize;
+
+        getThreadPool().parallelFor(chunks, [&](std::size_t c) {
+            std::size_t end = std::min(n, (c + 1) * chunkSize);
+            for (std::size_t r = c * chunkSize; r < end; ++r) {
+                const std::size_t first = offsets[r], last = offsets[r + 1];
+                if (first == last) continue;
+                double sum = 0.0;
+                for (std::size_t k = first; k < last; ++k) sum += grades[k];
+                out[source[r]] = sum / static_cast<double>(last - first);
+            }
+        });
+        return out;
+    }
+
+    // ========================
+    // Group-by aggregation (see group_by.hpp)
+    // Groups live students, or a subset given as getStudents() rows (for
+    // instance the result of select()), by any of branch / start year /
+    // course. Groups come back sorted by branch name, year, course code.
+    // ========================
+    std::vector<GroupRowT> groupBy(const GroupBySpec &spec) const {
+        ScopedTimer timer(Timer::GroupBy);
+        return GroupByEngine<RollT, CourseCodeT>(getColumns(), spec).run(getThreadPool());
+    }
+
+    std::vector<GroupRowT> groupBy(const GroupBySpec &spec,
+                                   const std::vector<std::size_t> &rows) const {
+        ScopedTimer timer(Timer::GroupBy);
+        const auto &cols   = getColumns();
+        const auto &source = cols.sourceRows();
+
+        // Student rows -> column rows; removed rows have no column row
+        std::vector<std::size_t> colRows;
+        colRows.reserve(rows.size());
+        for (std::size_t row : rows) {
+            auto it = std::lower_bound(source.begin(), source.end(), row);
+            if (it != source.end() && *it == row) colRows.push_back(it - source.begin());
+        }
+        return GroupByEngine<RollT, CourseCodeT>(cols, spec).run(getThreadPool(), &colRows);
+    }
+};
+
+#endif // DATABASE_HPP
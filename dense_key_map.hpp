@@ -0,0 +1,164 @@
+#ifndef DENSE_KEY_MAP_HPP
+#define DENSE_KEY_MAP_HPP
+
+#include "parallel_sort.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Direct-addressed map for integer keys
+// Course keys are small integers: interned CourseIds count up from 0,
+// and numeric course codes usually sit in a narrow band. While the keys
+// span at most a few times as many slots as there are entries, values
+// live in one array indexed by key - base, so a lookup is a subtraction
+// and a bounds check. Keys that would make the array sparse go to a
+// hash map instead; lookups only consult it when it is non-empty.
+//
+// References stay valid until the next insertion of a new key.
+// ========================
+
+template <typename Key, typename V>
+class DenseKeyMap {
+    static_assert(std::is_integral<Key>::value, "DenseKeyMap keys must be integral");
+
+private:
+    // Dense span allowed: max(MIN_SLOTS, DENSITY * entries)
+    static constexpr std::uint64_t MIN_SLOTS = 1024;
+    static constexpr std::uint64_t DENSITY   = 4;
+
+    std::uint64_t     base = 0;          // radixKey() of slot 0
+    std::vector<V>    values;
+    std::vector<char> present;
+    std::size_t       denseCount = 0;
+    std::unordered_map<Key, V> sparse;
+
+    static std::uint64_t ordinal(Key k) { return static_cast<std::uint64_t>(radixKey(k)); }
+
+    static Key keyAt(std::uint64_t ord) {
+        using U = std::make_unsigned_t<Key>;
+        U u = static_cast<U>(ord);
+        if constexpr (std::is_signed<Key>::value) u ^= U(1) << (sizeof(U) * 8 - 1);
+        return static_cast<Key>(u);
+    }
+
+    // Slot of `k`, or values.size() when it lies outside the array
+    std::size_t slotOf(Key k) const {
+        const std::uint64_t off = ordinal(k) - base;
+        return off < values.size() ? static_cast<std::size_t>(off) : values.size();
+    }
+
+    // Re-bases the array to cover `k` if that keeps it dense enough
+    bool widenTo(Key k) {
+        const std::uint64_t ord = ordinal(k);
+        std::uint64_t lo = ord, hi = ord;
+        if (!values.empty()) {
+            lo = std::min(lo, base);
+            hi = std::max(hi, base + values.size() - 1);
+        }
+        const std::uint64_t span  = hi - lo + 1;
+        const std::uint64_t limit = std::max(MIN_SLOTS, DENSITY * (size() + 1));
+        if (span == 0 || span > limit) return false;
+
+        // Headroom above the top key, so ascending inserts (new interned
+        // ids) re-base only O(log n) times
+        std::uint64_t slots = std::max(span, std::min(2 * span, limit));
+        const std::uint64_t room = 0 - lo;   // slots left above lo; 0 means all
+        if (room != 0 && slots > room) slots = room;
+        std::vector<V>    newValues(static_cast<std::size_t>(slots));
+        std::vector<char> newPresent(static_cast<std::size_t>(slots), 0);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (!present[i]) continue;
+            newValues[base + i - lo]  = std::move(values[i]);
+            newPresent[base + i - lo] = 1;
+        }
+        values.swap(newValues);
+        present.swap(newPresent);
+        base = lo;
+
+        // Sparse keys the array now covers move into it
+        for (auto it = sparse.begin(); it != sparse.end();) {
+            const std::size_t s = slotOf(it->first);
+            if (s == values.size()) {
+                ++it;
+                continue;
+            }
+            values[s]  = std::move(it->second);
+            present[s] = 1;
+            ++denseCount;
+            it = sparse.erase(it);
+        }
+        return true;
+    }
+
+public:
+    std::size_t size() const { return denseCount + sparse.size(); }
+    bool empty() const { return size() == 0; }
+
+    void clear() {
+        values.clear();
+        present.clear();
+        denseCount = 0;
+        sparse.clear();
+    }
+
+    V *find(Key k) {
+        const std::size_t s = slotOf(k);
+        if (s < values.size()) return present[s] ? &values[s] : nullptr;
+        if (sparse.empty()) return nullptr;
+        auto it = sparse.find(k);
+        return it == sparse.end() ? nullptr : &it->second;
+    }
+
+    const V *find(Key k) const { return const_cast<DenseKeyMap *>(this)->find(k); }
+
+    // Inserts a value-initialised V for a new key
+    V &operator[](Key k) {
+        std::size_t s = slotOf(k);
+        if (s == values.size()) {
+            auto it = sparse.find(k);
+            if (it != sparse.end()) return it->second;
+            if (!widenTo(k)) return sparse[k];
+            s = slotOf(k);
+        }
+        if (!present[s]) {
+            present[s] = 1;
+            ++denseCount;
+        }
+        return values[s];
+    }
+
+    bool erase(Key k) {
+        const std::size_t s = slotOf(k);
+        if (s < values.size()) {
+            if (!present[s]) return false;
+            values[s]  = V();
+            present[s] = 0;
+            --denseCount;
+            return true;
+        }
+        return sparse.erase(k) != 0;
+    }
+
+    // Calls fn(key, value) for every entry: array entries in key order,
+    // then the hashed ones in no set order
+    template <typename Fn>
+    void forEach(Fn fn) {
+        for (std::size_t i = 0; i < values.size(); ++i)
+            if (present[i]) fn(keyAt(base + i), values[i]);
+        for (auto &kv : sparse) fn(kv.first, kv.second);
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (std::size_t i = 0; i < values.size(); ++i)
+            if (present[i]) fn(keyAt(base + i), values[i]);
+        for (const auto &kv : sparse) fn(kv.first, kv.second);
+    }
+};
+
+#endif // DENSE_KEY_MAP_HPP
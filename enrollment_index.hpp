@@ -0,0 +1,126 @@
+#ifndef ENROLLMENT_INDEX_HPP
+#define ENROLLMENT_INDEX_HPP
+
+#include "row_bitmap.hpp"
+#include "symbol_table.hpp"
+#include "thread_pool.hpp"
+#include "dense_key_map.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+// Which course list of a student a course filter looks at
+enum class CourseRole { Current, Completed, Any };
+
+// ========================
+// Course enrollment index
+// Inverted index from case-folded course key to the bitmap of student
+// rows taking it (current courses) and having passed it (completed),
+// kept separately. "Enrolled in OOPD" is a single direct-addressed
+// lookup (see dense_key_map.hpp), and
+// AND/OR filters over several courses are bitmap operations.
+// ========================
+
+template <typename CourseCodeT>
+class EnrollmentIndex {
+public:
+    using KeyTraits = CourseKeyTraits<CourseCodeT>;
+    using CourseKey = typename KeyTraits::Key;
+    using Bitmaps   = DenseKeyMap<CourseKey, RowBitmap>;
+
+private:
+    Bitmaps current;
+    Bitmaps completed;
+
+    // 64K rows per build task: matches the bitmap container size, so
+    // the per-task bitmaps can be stitched without merging
+    static constexpr std::size_t CHUNK_ROWS = std::size_t(1) << 16;
+
+    template <typename StudentT>
+    static void addTo(Bitmaps &cur, Bitmaps &done, const StudentT &s, std::size_t row) {
+        for (auto c : s.getCurrentCourseKeys())
+            cur[KeyTraits::folded(c)].add(row);
+        for (const auto &p : s.getCompletedCourseKeys())
+            done[KeyTraits::folded(p.first)].add(row);
+    }
+
+    static void removeFrom(Bitmaps &m, CourseKey key, std::size_t row) {
+        RowBitmap *rows = m.find(key);
+        if (!rows) return;
+        rows->remove(row);
+        if (rows->empty()) m.erase(key);
+    }
+
+    static const RowBitmap *lookup(const Bitmaps &m, CourseKey key) {
+        return m.find(key);
+    }
+
+public:
+    void clear() {
+        current.clear();
+        completed.clear();
+    }
+
+    // Indexes all of `students` on the pool, one task per 64K rows
+    template <typename StudentT>
+    void build(const std::vector<StudentT> &students, ThreadPool &pool) {
+        clear();
+
+        const std::size_t n = students.size();
+        const std::size_t chunks = (n + CHUNK_ROWS - 1) / CHUNK_ROWS;
+        std::vector<Bitmaps> cur(chunks), done(chunks);
+
+        pool.parallelFor(chunks, [&](std::size_t c) {
+            std::size_t end = std::min(n, (c + 1) * CHUNK_ROWS);
+            for (std::size_t i = c * CHUNK_ROWS; i < end; ++i)
+                addTo(cur[c], done[c], students[i], i);
+        });
+
+        for (std::size_t c = 0; c < chunks; ++c) {
+            cur[c].forEach([this](CourseKey k, RowBitmap &rows) {
+                current[k].append(std::move(rows));
+            });
+            done[c].forEach([this](CourseKey k, RowBitmap &rows) {
+                completed[k].append(std::move(rows));
+            });
+        }
+    }
+
+    template <typename StudentT>
+    void add(const StudentT &s, std::size_t row) {
+        addTo(current, completed, s, row);
+    }
+
+    // Call with the record as it was indexed, before it is changed
+    template <typename StudentT>
+    void remove(const StudentT &s, std::size_t row) {
+        for (auto c : s.getCurrentCourseKeys())
+            removeFrom(current, KeyTraits::folded(c), row);
+        for (const auto &p : s.getCompletedCourseKeys())
+            removeFrom(completed, KeyTraits::folded(p.first), row);
+    }
+
+    // Rows with `folded` (a case-folded key) in the given list(s)
+    RowBitmap rows(CourseKey folded, CourseRole role) const {
+        const RowBitmap *cur  = role != CourseRole::Completed ? lookup(current, folded) : nullptr;
+        const RowBitmap *done = role != CourseRole::Current ? lookup(completed, folded) : nullptr;
+        if (cur && done) return *cur | *done;
+        if (cur) return *cur;
+        if (done) return *done;
+        return RowBitmap();
+    }
+
+    const Bitmaps &currentBitmaps() const { return current; }
+    const Bitmaps &completedBitmaps() const { return completed; }
+
+    std::size_t memoryBytes() const {
+        std::size_t n = 0;
+        auto add = [&n](CourseKey, const RowBitmap &rows) { n += rows.memoryBytes(); };
+        current.forEach(add);
+        completed.forEach(add);
+        return n;
+    }
+};
+
+#endif // ENROLLMENT_INDEX_HPP
@@ -0,0 +1,318 @@
+#ifndef EXTERNAL_SORT_HPP
+#define EXTERNAL_SORT_HPP
+
+#include "csv_parse.hpp"
+#include "parallel_sort.hpp"
+#include "thread_pool.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// External (out-of-core) sort of a student CSV by roll
+// For rosters larger than RAM: nothing but one run is ever in memory.
+//
+//   1. Run formation: the CSV is streamed into a text arena plus a line
+//      index until they reach the memory cap. The run is sorted with the
+//      same parallel block sort + tree merge as parallelSortByRoll()
+//      (radix sort for integral rolls) and spilled to a temporary file.
+//   2. Merge: the runs are merged k ways through a min-heap, at most
+//      maxFanIn at a time (extra passes only for huge inputs), into the
+//      roll-ordered output, which keeps the header line.
+//
+// Equal rolls keep their input order. Lines without a parsable roll are
+// dropped and counted.
+// ========================
+
+struct ExternalSortOptions {
+    std::size_t memoryLimit = std::size_t(256) << 20;   // bytes per run
+    std::size_t numThreads  = 2;
+    std::size_t maxFanIn    = 64;     // runs merged at once
+    std::string tempDir     = ".";
+};
+
+struct ExternalSortStats {
+    std::size_t rows     = 0;
+    std::size_t skipped  = 0;   // lines without a parsable roll
+    std::size_t runs     = 0;   // sorted runs spilled
+    std::size_t passes   = 0;   // merge passes
+    std::size_t bytesIn  = 0;
+    long long   runMicros   = 0;
+    long long   mergeMicros = 0;
+};
+
+template <typename RollT>
+class ExternalRollSorter {
+private:
+    static constexpr bool integralRoll =
+        std::is_integral<RollT>::value && !std::is_same<RollT, bool>::value;
+
+    // Parsed roll: the value for integral rolls, else unused (rolls are
+    // compared as text)
+    using RollKey = std::conditional_t<integralRoll, RollT, char>;
+
+    struct Line {
+        std::size_t   off;       // into the run arena
+        std::uint32_t len;       // without '\n'
+        std::uint32_t rollPos;   // roll field, relative to off
+        std::uint32_t rollLen;
+        RollKey       key;
+    };
+
+    ThreadPool         &pool;
+    ExternalSortOptions opts;
+    ExternalSortStats   st;
+    std::vector<std::string> tempFiles;
+
+    // Locates (and for integral rolls parses) the roll field
+    static bool parseRoll(std::string_view line, std::uint32_t &pos,
+                          std::uint32_t &len, RollKey &key) {
+        FieldCursor fields(line);
+        std::string_view name, roll;
+        if (!fields.next(',', name) || !fields.next(',', roll)) return false;
+        roll = trimView(roll);
+        if (roll.empty()) return false;
+        pos = static_cast<std::uint32_t>(roll.data() - line.data());
+        len = static_cast<std::uint32_t>(roll.size());
+        if constexpr (integralRoll) return parseNumber(roll, key);
+        else return true;
+    }
+
+    static bool rollLess(std::string_view a, const RollKey &ka,
+                         std::string_view b, const RollKey &kb) {
+        if constexpr (integralRoll) {
+            (void)a; (void)b;
+            return ka < kb;
+        } else {
+            (void)ka; (void)kb;
+            return a < b;
+        }
+    }
+
+    std::string tempPath(std::size_t id) const {
+        return opts.tempDir + "/extsort." + std::to_string(id) + "." +
+               std::to_string(reinterpret_cast<std::uintptr_t>(this)) + ".run";
+    }
+
+    // Sorts one in-memory run and writes it to `path`
+    bool spillRun(const std::string &arena, std::vector<Line> &lines,
+                  const std::string &path, const std::string *header) {
+        const char *base = arena.data();
+        auto rollOf = [base](const Line &l) {
+            return std::string_view(base + l.off + l.rollPos, l.rollLen);
+        };
+        auto comp = [&rollOf](const Line &a, const Line &b) {
+            return rollLess(rollOf(a), a.key, rollOf(b), b.key);
+        };
+
+        SortTimings timings;
+        const std::size_t threads =
+            std::max<std::size_t>(1, std::min(opts.numThreads, lines.size()));
+        parallelBlockSortMerge(
+            pool, lines, threads, comp,
+            [&comp](Line *first, Line *last) {
+                if constexpr (integralRoll) {
+                    radixSortByKey(first, last, [](const Line &l) { return radixKey(l.key); });
+                } else {
+                    std::stable_sort(first, last, comp);
+                }
+            },
+            timings);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        if (header) out << *header << '\n';
+        for (const Line &l : lines) {
+            out.write(base + l.off, l.len);
+            out.put('\n');
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Cursor over one sorted run file
+    struct RunReader {
+        std::ifstream   in;
+        std::string     line;
+        std::uint32_t   rollPos = 0, rollLen = 0;
+        RollKey         key{};
+        std::vector<char> buf;
+
+        RunReader(const std::string &path, std::size_t bufBytes) : buf(bufBytes) {
+            in.rdbuf()->pubsetbuf(buf.data(), static_cast<std::streamsize>(buf.size()));
+            in.open(path, std::ios::binary);
+        }
+
+        bool next() {
+            while (std::getline(in, line))
+                if (parseRoll(line, rollPos, rollLen, key)) return true;
+            return false;
+        }
+
+        std::string_view roll() const {
+            return std::string_view(line).substr(rollPos, rollLen);
+        }
+    };
+
+    // k-way merges `inputs` into `output`
+    bool mergeRuns(const std::vector<std::string> &inputs, const std::string &output,
+                   const std::string *header) {
+        const std::size_t bufBytes = std::max<std::size_t>(
+            64 * 1024, opts.memoryLimit / (inputs.size() + 1));
+
+        std::vector<std::unique_ptr<RunReader>> readers;
+        for (const auto &path : inputs) {
+            readers.push_back(std::make_unique<RunReader>(path, bufBytes));
+            if (!readers.back()->in) return false;
+        }
+
+        // Min-heap on (roll, run index): ties go to the earlier run,
+        // which holds the earlier input lines
+        auto greater = [&readers](std::size_t a, std::size_t b) {
+            const RunReader &ra = *readers[a], &rb = *readers[b];
+            if (rollLess(rb.roll(), rb.key, ra.roll(), ra.key)) return true;
+            if (rollLess(ra.roll(), ra.key, rb.roll(), rb.key)) return false;
+            return a > b;
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)>
+            heap(greater);
+        for (std::size_t i = 0; i < readers.size(); ++i)
+            if (readers[i]->next()) heap.push(i);
+
+        std::vector<char> outBuf(bufBytes);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(outBuf.data(), static_cast<std::streamsize>(outBuf.size()));
+        out.open(output, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        if (header) out << *header << '\n';
+
+        while (!heap.empty()) {
+            const std::size_t i = heap.top();
+            heap.pop();
+            out << readers[i]->line << '\n';
+            if (readers[i]->next()) heap.push(i);
+        }
+        return static_cast<bool>(out.flush());
+    }
+
+    void removeTempFiles() {
+        for (const auto &f : tempFiles) std::remove(f.c_str());
+        tempFiles.clear();
+    }
+
+public:
+    ExternalRollSorter(ThreadPool &pool, ExternalSortOptions opts = ExternalSortOptions())
+        : pool(pool), opts(std::move(opts)) {
+        if (this->opts.maxFanIn < 2) this->opts.maxFanIn = 2;
+    }
+
+    ~ExternalRollSorter() { removeTempFiles(); }
+
+    const ExternalSortStats &stats() const { return st; }
+
+    // Writes the rows of CSV `input` to `output` in roll order; false on
+    // an I/O error. `output` must differ from `input`.
+    bool sort(const std::string &input, const std::string &output) {
+        using clock = std::chrono::high_resolution_clock;
+        auto micros = [](clock::time_point a, clock::time_point b) {
+            return static_cast<long long>(
+                std::chrono::duration_cast<std::chrono::microseconds>(b - a).count());
+        };
+
+        st = ExternalSortStats();
+        removeTempFiles();
+
+        std::ifstream in(input, std::ios::binary | std::ios::ate);
+        if (!in) return false;
+        const auto fileSize = static_cast<std::size_t>(in.tellg());
+        in.seekg(0);
+
+        // ---- Phase 1: bounded-memory sorted runs ----
+        auto runStart = clock::now();
+        std::string header;
+        bool haveHeader = false;
+        std::string arena, line;
+        std::vector<Line> lines;
+        std::vector<std::string> runs;
+        arena.reserve(std::min(fileSize, opts.memoryLimit));
+
+        // Index entries are counted twice: the tree merge needs a buffer
+        auto runBytes = [&] { return arena.size() + 2 * lines.size() * sizeof(Line); };
+
+        auto flush = [&]() {
+            if (lines.empty()) return true;
+            runs.push_back(tempPath(tempFiles.size()));
+            tempFiles.push_back(runs.back());
+            bool ok = spillRun(arena, lines, runs.back(), nullptr);
+            arena.clear();
+            lines.clear();
+            return ok;
+        };
+
+        while (std::getline(in, line)) {
+            st.bytesIn += line.size() + 1;
+            if (trimView(line).empty()) continue;
+            if (!haveHeader) {
+                header = line;
+                haveHeader = true;
+                continue;
+            }
+
+            Line l{arena.size(), static_cast<std::uint32_t>(line.size()), 0, 0, RollKey{}};
+            if (!parseRoll(line, l.rollPos, l.rollLen, l.key)) {
+                ++st.skipped;
+                continue;
+            }
+            arena += line;
+            lines.push_back(l);
+            ++st.rows;
+            if (runBytes() >= opts.memoryLimit && !flush()) return false;
+        }
+
+        // Everything fit in memory: sort straight into the output
+        const std::string *hdr = haveHeader ? &header : nullptr;
+        if (runs.empty()) {
+            st.runs = 1;
+            bool ok = spillRun(arena, lines, output, hdr);
+            st.runMicros = micros(runStart, clock::now());
+            return ok;
+        }
+        if (!flush()) return false;
+        std::string().swap(arena);
+        std::vector<Line>().swap(lines);
+        st.runs = runs.size();
+        st.runMicros = micros(runStart, clock::now());
+
+        // ---- Phase 2: k-way merge, maxFanIn runs at a time ----
+        auto mergeStart = clock::now();
+        while (runs.size() > opts.maxFanIn) {
+            std::vector<std::string> next;
+            for (std::size_t i = 0; i < runs.size(); i += opts.maxFanIn) {
+                std::vector<std::string> group(
+                    runs.begin() + i, runs.begin() + std::min(runs.size(), i + opts.maxFanIn));
+                next.push_back(tempPath(tempFiles.size()));
+                tempFiles.push_back(next.back());
+                if (!mergeRuns(group, next.back(), nullptr)) return false;
+                for (const auto &f : group) std::remove(f.c_str());
+            }
+            runs.swap(next);
+            ++st.passes;
+        }
+        bool ok = mergeRuns(runs, output, hdr);
+        ++st.passes;
+        st.mergeMicros = micros(mergeStart, clock::now());
+        removeTempFiles();
+        return ok;
+    }
+};
+
+#endif // EXTERNAL_SORT_HPP
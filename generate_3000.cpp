@@ -1,88 +1,67 @@
-// generate_3000.cpp
-#include <iostream>
-#include <fstream>
-#include <vector>
-#include <string>
-#include <numeric>
-#include <algorithm>
-#include <random>
-#include <unordered_set>
-
-int main() {
-    const std::string filename = "oopd_students.csv";
-
-    std::ofstream out(filename);
-    if (!out) {
-        std::cerr << "Could not open " << filename << " for writing\n";
-        return 1;
-    }
-
-    // CSV header (MUST match what your main program expects)
-    out << "name,roll,branch,startYear,currentCourses,completedCourses\n";
-
-    std::vector<std::string> branches = {"cse", "ece", "csam", "csai", "csd", "csss"};
-    std::vector<std::string> currentCoursePool   = {"oopd", "dbms", "ml", "ga", "os", "math"};
-    std::vector<std::string> completedCoursePool = {"12345", "23456", "34567", "45678", "56789"};
-
-    // Create 3000 unique roll numbers and shuffle them for random order
-    std::vector<int> rolls(3000);
-    std::iota(rolls.begin(), rolls.end(), 20000);   // 20000–22999
-
-    std::random_device rd;
-    std::mt19937 rng(rd());
-    std::shuffle(rolls.begin(), rolls.end(), rng);
-
-    std::uniform_int_distribution<int> yearDist(2020, 2024);
-    std::uniform_int_distribution<int> branchDist(0, (int)branches.size() - 1);
-    std::uniform_int_distribution<int> currCountDist(1, 3);     // 1–3 current courses
-    std::uniform_int_distribution<int> compCountDist(1, 3);     // 1–3 completed courses
-    std::uniform_int_distribution<int> currPoolDist(0, (int)currentCoursePool.size() - 1);
-    std::uniform_int_distribution<int> compPoolDist(0, (int)completedCoursePool.size() - 1);
-    std::uniform_real_distribution<double> gradeDist(5.0, 10.0); // grades between 5 and 10
-
-    for (int i = 0; i < 3000; ++i) {
-        std::string name   = "student" + std::to_string(i + 1);
-        int rollNum        = rolls[i];
-        std::string roll   = std::to_string(rollNum);
-        std::string branch = branches[branchDist(rng)];
-        int startYear      = yearDist(rng);
-
-        // ---- Unique current courses ----
-        int curN = currCountDist(rng);
-        std::unordered_set<std::string> usedCurrent;
-        while ((int)usedCurrent.size() < curN) {
-            usedCurrent.insert(currentCoursePool[currPoolDist(rng)]);
-        }
-
-        std::string currentCourses;
-        for (const auto &c : usedCurrent) {
-            if (!currentCourses.empty()) currentCourses += ";";
-            currentCourses += c;
-        }
-
-        // ---- Unique completed courses ----
-        int compN = compCountDist(rng);
-        std::unordered_set<std::string> usedCompleted;
-        while ((int)usedCompleted.size() < compN) {
-            usedCompleted.insert(completedCoursePool[compPoolDist(rng)]);
-        }
-
-        std::string completedCourses;
-        for (const auto &code : usedCompleted) {
-            if (!completedCourses.empty()) completedCourses += ";";
-            double grade = gradeDist(rng);
-            completedCourses += code + ":" + std::to_string(grade);
-        }
-
-        // Write CSV row
-        out << name << ","
-            << roll << ","
-            << branch << ","
-            << startYear << ","
-            << currentCourses << ","
-            << completedCourses << "\n";
-    }
-
-    std::cout << "Generated 3000 entries in " << filename << "\n";
-    return 0;
-}
+// generate_3000.cpp
+// Writes a synthetic student CSV. With no arguments: the classic 3000-row
+// oopd_students.csv (rolls 20000-22999, six branches, six current and
+// five completed courses), now reproducible from a fixed seed.
+//
+//   ./gen3000 --rows 10000000 --seed 7 --completed-courses 500 --zipf 1.1 --out big.csv
+#include "generator.hpp"
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+static void usage() {
+    std::cerr << "usage: gen3000 [--rows N] [--seed N] [--branches N]"
+                 " [--current-courses N] [--completed-courses N]\n"
+                 "               [--max-current N] [--max-completed N] [--zipf S]"
+                 " [--first-roll N] [--threads N] [--numeric-courses]\n"
+                 "               [--out FILE]\n";
+}
+
+int main(int argc, char **argv) {
+    GeneratorOptions opts;
+    std::string filename = "oopd_students.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--numeric-courses") {   // integer course codes only
+            opts.numericCourses = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        const char *value = argv[++i];
+        char *end = nullptr;
+        const unsigned long long n = std::strtoull(value, &end, 10);
+        const bool isNumber = end != value && *end == '\0';
+
+        if (arg == "--out") filename = value;
+        else if (arg == "--zipf") opts.zipf = std::atof(value);
+        else if (!isNumber) { usage(); return 2; }
+        else if (arg == "--rows") opts.rows = n;
+        else if (arg == "--seed") opts.seed = n;
+        else if (arg == "--branches") opts.branches = n;
+        else if (arg == "--current-courses") opts.currentCourses = n;
+        else if (arg == "--completed-courses") opts.completedCourses = n;
+        else if (arg == "--max-current") opts.maxCurrent = n;
+        else if (arg == "--max-completed") opts.maxCompleted = n;
+        else if (arg == "--first-roll") opts.firstRoll = n;
+        else if (arg == "--threads") opts.threads = n;
+        else { usage(); return 2; }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    DatasetGenerator gen(opts);
+    if (!gen.write(filename)) {
+        std::cerr << "Could not write " << filename << "\n";
+        return 1;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::cout << "Generated " << opts.rows << " entries in " << filename << " ("
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms)\n";
+    return 0;
+}
@@ -0,0 +1,266 @@
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include "thread_pool.hpp"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <charconv>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Deterministic synthetic student CSV generator
+// Row count, seed, vocabulary sizes and skew are parameters, and the
+// output depends on nothing else: not on the thread count, not on the
+// standard library (the RNG and its mappings are our own). Re-running
+// with the same options reproduces the file byte for byte.
+//
+// Rows are produced in fixed-size chunks, each with its own RNG stream
+// (derived from the seed and the chunk number), formatted in parallel
+// into per-chunk buffers and written in order as large blocks.
+//
+// Rolls are unique: firstRoll + a keyed pseudo-random permutation of
+// [0, rows), computed per row without a shuffle table. With zipf > 0,
+// branches and courses follow a Zipf distribution of that exponent
+// (item k drawn with weight 1 / k^zipf), so a few courses get most of
+// the enrollments.
+// ========================
+
+struct GeneratorOptions {
+    std::size_t   rows             = 3000;
+    std::uint64_t seed             = 1;
+    std::size_t   branches         = 6;
+    std::size_t   currentCourses   = 6;    // vocabulary sizes
+    std::size_t   completedCourses = 5;
+    std::size_t   maxCurrent       = 3;    // courses per student, 1..max
+    std::size_t   maxCompleted     = 3;
+    double        zipf             = 0.0;  // 0 = uniform
+    std::uint64_t firstRoll        = 20000;
+    std::size_t   threads          = 0;    // 0 = all hardware threads
+    bool          numericCourses   = false;  // integer current-course codes too, so
+                                             // StudentDatabase<unsigned, int> loads it
+};
+
+class DatasetGenerator {
+private:
+    static constexpr std::size_t CHUNK_ROWS = 64 * 1024;
+
+    // ---- RNG: splitmix64 seeding + xoshiro256** ----
+    static std::uint64_t splitmix(std::uint64_t &x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    class Rng {
+    private:
+        std::uint64_t s[4];
+
+        static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    public:
+        Rng(std::uint64_t seed, std::uint64_t stream) {
+            std::uint64_t x = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+            for (auto &w : s) w = splitmix(x);
+        }
+
+        std::uint64_t next() {
+            const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+            const std::uint64_t t = s[1] << 17;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+            return result;
+        }
+
+        // [0, n)
+        std::size_t below(std::size_t n) {
+            return static_cast<std::size_t>(
+                (static_cast<unsigned __int128>(next()) * n) >> 64);
+        }
+
+        // [0, 1)
+        double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+    };
+
+    // Draws an index in [0, n): uniform, or Zipf through a CDF table
+    class Picker {
+    private:
+        std::size_t         n;
+        std::vector<double> cdf;   // empty when uniform
+
+    public:
+        Picker(std::size_t n, double zipf) : n(n) {
+            if (zipf <= 0.0 || n < 2) return;
+            cdf.resize(n);
+            double total = 0;
+            for (std::size_t k = 0; k < n; ++k) {
+                total += 1.0 / std::pow(static_cast<double>(k + 1), zipf);
+                cdf[k] = total;
+            }
+            for (auto &c : cdf) c /= total;
+        }
+
+        std::size_t operator()(Rng &rng) const {
+            if (cdf.empty()) return rng.below(n);
+            auto it = std::upper_bound(cdf.begin(), cdf.end(), rng.unit());
+            return std::min<std::size_t>(it - cdf.begin(), n - 1);
+        }
+    };
+
+    GeneratorOptions         opts;
+    std::vector<std::string> branchNames, currentNames, completedNames;
+    Picker                   branchPick, currentPick, completedPick;
+    unsigned                 halfBits = 1;
+    std::uint64_t            roundKeys[4] = {};
+
+    // Keyed bijection on [0, 4^halfBits): a 4-round Feistel network
+    std::uint64_t feistel(std::uint64_t x) const {
+        const std::uint64_t mask = (std::uint64_t(1) << halfBits) - 1;
+        std::uint64_t l = x >> halfBits, r = x & mask;
+        for (std::uint64_t key : roundKeys) {
+            std::uint64_t h = r ^ key;
+            const std::uint64_t f = splitmix(h) & mask;
+            const std::uint64_t next = l ^ f;
+            l = r;
+            r = next;
+        }
+        return (l << halfBits) | r;
+    }
+
+    // Bijection on [0, rows): cycle-walk the Feistel network until the
+    // value lands in range (under 4 steps on average)
+    std::uint64_t permute(std::uint64_t i) const {
+        do {
+            i = feistel(i);
+        } while (i >= opts.rows);
+        return i;
+    }
+
+    // Built-in names first (the classic dataset), then synthetic ones
+    static std::vector<std::string> vocabulary(std::size_t n, std::vector<std::string> base,
+                                               const std::string &prefix, std::size_t from) {
+        base.resize(std::min(base.size(), n));
+        for (std::size_t i = base.size(); i < n; ++i)
+            base.push_back(prefix + std::to_string(from + i));
+        return base;
+    }
+
+    // Distinct picks, up to `want` of them (strong skew may give fewer)
+    static void pickDistinct(Rng &rng, const Picker &pick, std::size_t vocab,
+                             std::size_t want, std::vector<std::size_t> &out) {
+        out.clear();
+        want = std::min(want, vocab);
+        for (std::size_t tries = 0; out.size() < want && tries < 8 * want; ++tries) {
+            std::size_t k = pick(rng);
+            if (std::find(out.begin(), out.end(), k) == out.end()) out.push_back(k);
+        }
+    }
+
+    template <typename T>
+    static void appendNumber(std::string &out, T v) {
+        char tmp[32];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        out.append(tmp, res.ptr);
+    }
+
+    void formatChunk(std::size_t chunk, std::string &out) const {
+        Rng rng(opts.seed, chunk);
+        std::vector<std::size_t> picks;
+        char grade[32];
+
+        const std::size_t first = chunk * CHUNK_ROWS;
+        const std::size_t last  = std::min(opts.rows, first + CHUNK_ROWS);
+        out.clear();
+        out.reserve((last - first) * 96);
+
+        for (std::size_t i = first; i < last; ++i) {
+            out += "student";
+            appendNumber(out, i + 1);
+            out += ',';
+            appendNumber(out, opts.firstRoll + permute(i));
+            out += ',';
+            out += branchNames[branchPick(rng)];
+            out += ',';
+            appendNumber(out, 2020 + rng.below(5));
+            out += ',';
+
+            pickDistinct(rng, currentPick, currentNames.size(),
+                         1 + rng.below(opts.maxCurrent), picks);
+            for (std::size_t k = 0; k < picks.size(); ++k) {
+                if (k) out += ';';
+                out += currentNames[picks[k]];
+            }
+            out += ',';
+
+            pickDistinct(rng, completedPick, completedNames.size(),
+                         1 + rng.below(opts.maxCompleted), picks);
+            for (std::size_t k = 0; k < picks.size(); ++k) {
+                if (k) out += ';';
+                out += completedNames[picks[k]];
+                out += ':';
+                auto res = std::to_chars(grade, grade + sizeof(grade), 5.0 + 5.0 * rng.unit(),
+                                         std::chars_format::fixed, 6);
+                out.append(grade, res.ptr);
+            }
+            out += '\n';
+        }
+    }
+
+public:
+    explicit DatasetGenerator(GeneratorOptions o)
+        : opts(o),
+          branchNames(vocabulary(std::max<std::size_t>(1, o.branches),
+                                 {"cse", "ece", "csam", "csai", "csd", "csss"}, "branch", 1)),
+          currentNames(o.numericCourses
+                           ? vocabulary(std::max<std::size_t>(1, o.currentCourses), {}, "", 10001)
+                           : vocabulary(std::max<std::size_t>(1, o.currentCourses),
+                                        {"oopd", "dbms", "ml", "ga", "os", "math"}, "course", 1)),
+          completedNames(vocabulary(std::max<std::size_t>(1, o.completedCourses),
+                                    {"12345", "23456", "34567", "45678", "56789"}, "", 60000)),
+          branchPick(branchNames.size(), o.zipf),
+          currentPick(currentNames.size(), o.zipf),
+          completedPick(completedNames.size(), o.zipf) {
+        opts.maxCurrent   = std::max<std::size_t>(1, opts.maxCurrent);
+        opts.maxCompleted = std::max<std::size_t>(1, opts.maxCompleted);
+
+        // Smallest even-width domain holding every row number
+        while ((std::uint64_t(1) << (2 * halfBits)) < opts.rows) ++halfBits;
+        std::uint64_t x = opts.seed ^ 0x5DEECE66DULL;
+        for (auto &k : roundKeys) k = splitmix(x);
+    }
+
+    // Writes the header and every row to `path`; false on an I/O error
+    bool write(const std::string &path) const {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out << "name,roll,branch,startYear,currentCourses,completedCourses\n";
+
+        ThreadPool pool(opts.threads ? opts.threads : ThreadPool::defaultWorkers());
+        const std::size_t chunks = (opts.rows + CHUNK_ROWS - 1) / CHUNK_ROWS;
+        const std::size_t batch  = 2 * pool.size();
+        std::vector<std::string> buffers(batch);
+
+        // Format a batch in parallel, write it in order, repeat
+        for (std::size_t c0 = 0; c0 < chunks; c0 += batch) {
+            const std::size_t n = std::min(batch, chunks - c0);
+            pool.parallelFor(n, [&](std::size_t k) { formatChunk(c0 + k, buffers[k]); });
+            for (std::size_t k = 0; k < n; ++k)
+                out.write(buffers[k].data(), static_cast<std::streamsize>(buffers[k].size()));
+            if (!out) return false;
+        }
+        return static_cast<bool>(out.flush());
+    }
+
+    const GeneratorOptions &options() const { return opts; }
+};
+
+#endif // GENERATOR_HPP
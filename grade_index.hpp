@@ -0,0 +1,226 @@
+#ifndef GRADE_INDEX_HPP
+#define GRADE_INDEX_HPP
+
+#include "parallel_sort.hpp"
+#include "thread_pool.hpp"
+#include "dense_key_map.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+
+// ========================
+// Sorted-array grade index
+// For every course, the (grade, student index) pairs are kept in two
+// parallel contiguous arrays ordered by grade descending, ties by student
+// index ascending. Range and top-K queries are binary searches that
+// return a slice of those arrays, so nothing is copied per query.
+// Courses are found by direct addressing on the course key (see
+// dense_key_map.hpp).
+// ========================
+
+template <typename CourseKey>
+class GradeIndex {
+public:
+    // All grades of one course, best first
+    struct CourseGrades {
+        std::vector<double>      grades;
+        std::vector<std::size_t> rows;
+
+        std::size_t size() const { return grades.size(); }
+    };
+
+    // A contiguous slice of one course's entries. Valid until the index
+    // is next modified.
+    class Range {
+    private:
+        const double      *g = nullptr;
+        const std::size_t *r = nullptr;
+        std::size_t        n = 0;
+
+    public:
+        struct Entry {
+            double      grade;
+            std::size_t row;
+        };
+
+        class iterator {
+        private:
+            const double      *g;
+            const std::size_t *r;
+
+        public:
+            iterator(const double *g, const std::size_t *r) : g(g), r(r) {}
+            Entry operator*() const { return {*g, *r}; }
+            iterator &operator++() { ++g; ++r; return *this; }
+            bool operator!=(const iterator &o) const { return g != o.g; }
+            bool operator==(const iterator &o) const { return g == o.g; }
+        };
+
+        Range() = default;
+        Range(const double *g, const std::size_t *r, std::size_t n) : g(g), r(r), n(n) {}
+
+        std::size_t size() const { return n; }
+        bool empty() const { return n == 0; }
+        double grade(std::size_t i) const { return g[i]; }
+        std::size_t row(std::size_t i) const { return r[i]; }
+        const double *gradeData() const { return g; }
+        const std::size_t *rowData() const { return r; }
+        iterator begin() const { return iterator(g, r); }
+        iterator end() const { return iterator(g + n, r + n); }
+    };
+
+private:
+    using Courses = DenseKeyMap<CourseKey, CourseGrades>;
+
+    Courses courses;
+
+    // Orders entries best-first: grade descending, then row ascending
+    static bool before(double ga, std::size_t ra, double gb, std::size_t rb) {
+        return ga > gb || (ga == gb && ra < rb);
+    }
+
+    static std::size_t positionOf(const CourseGrades &c, double grade, std::size_t row) {
+        std::size_t lo = 0, hi = c.size();
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (before(c.grades[mid], c.rows[mid], grade, row))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    // First position whose grade is below `minGrade`
+    static std::size_t endOfAtLeast(const CourseGrades &c, double minGrade) {
+        return static_cast<std::size_t>(
+            std::partition_point(c.grades.begin(), c.grades.end(),
+                                 [minGrade](double g) { return g >= minGrade; }) -
+            c.grades.begin());
+    }
+
+    static Range slice(const CourseGrades &c, std::size_t first, std::size_t last) {
+        return Range(c.grades.data() + first, c.rows.data() + first, last - first);
+    }
+
+public:
+    using Pairs   = std::vector<std::pair<double, std::size_t>>;
+    using Entries = DenseKeyMap<CourseKey, Pairs>;
+
+    void clear() { courses.clear(); }
+    std::size_t courseCount() const { return courses.size(); }
+
+    // Visit with allCourses().forEach(fn(key, grades))
+    const Courses &allCourses() const {
+        return courses;
+    }
+
+    const CourseGrades *find(const CourseKey &course) const {
+        return courses.find(course);
+    }
+
+    // ------------------------
+    // Bulk build
+    // `entries[course]` holds unsorted (grade, row) pairs. Courses are
+    // sorted concurrently on the pool; large courses additionally use the
+    // parallel block sort + tree merge from parallel_sort.hpp.
+    // ------------------------
+    void build(Entries &&entries, ThreadPool &pool) {
+        courses.clear();
+
+        std::vector<std::pair<CourseKey, Pairs *>> work;
+        entries.forEach([&](CourseKey k, Pairs &pairs) {
+            courses[k];
+            work.emplace_back(k, &pairs);
+        });
+
+        auto comp = [](const std::pair<double, std::size_t> &a,
+                       const std::pair<double, std::size_t> &b) {
+            return before(a.first, a.second, b.first, b.second);
+        };
+
+        const std::size_t parallelThreshold = 64 * 1024;
+
+        pool.parallelFor(work.size(), [&](std::size_t k) {
+            Pairs &pairs = *work[k].second;
+            if (pairs.size() >= parallelThreshold) {
+                SortTimings ignored;
+                parallelBlockSortMerge(
+                    pool, pairs, pool.size(), comp,
+                    [&comp](std::pair<double, std::size_t> *first,
+                            std::pair<double, std::size_t> *last) {
+                        std::sort(first, last, comp);
+                    },
+                    ignored);
+            } else {
+                std::sort(pairs.begin(), pairs.end(), comp);
+            }
+
+            CourseGrades &c = *courses.find(work[k].first);
+            c.grades.reserve(pairs.size());
+            c.rows.reserve(pairs.size());
+            for (const auto &p : pairs) {
+                c.grades.push_back(p.first);
+                c.rows.push_back(p.second);
+            }
+            Pairs().swap(pairs);
+        });
+    }
+
+    // ------------------------
+    // Incremental updates
+    // ------------------------
+    void insert(const CourseKey &course, double grade, std::size_t row) {
+        CourseGrades &c = courses[course];
+        std::size_t pos = positionOf(c, grade, row);
+        c.grades.insert(c.grades.begin() + pos, grade);
+        c.rows.insert(c.rows.begin() + pos, row);
+    }
+
+    void erase(const CourseKey &course, double grade, std::size_t row) {
+        CourseGrades *found = courses.find(course);
+        if (!found) return;
+
+        CourseGrades &c = *found;
+        std::size_t pos = positionOf(c, grade, row);
+        if (pos < c.size() && c.rows[pos] == row) {
+            c.grades.erase(c.grades.begin() + pos);
+            c.rows.erase(c.rows.begin() + pos);
+        }
+        if (c.grades.empty()) courses.erase(course);
+    }
+
+    // ------------------------
+    // Queries
+    // ------------------------
+
+    // Grades >= minGrade, best first
+    Range atLeast(const CourseKey &course, double minGrade) const {
+        const CourseGrades *c = find(course);
+        if (!c) return Range();
+        return slice(*c, 0, endOfAtLeast(*c, minGrade));
+    }
+
+    // Grades in [minGrade, maxGrade], best first
+    Range between(const CourseKey &course, double minGrade, double maxGrade) const {
+        const CourseGrades *c = find(course);
+        if (!c || minGrade > maxGrade) return Range();
+
+        std::size_t first = static_cast<std::size_t>(
+            std::partition_point(c->grades.begin(), c->grades.end(),
+                                 [maxGrade](double g) { return g > maxGrade; }) -
+            c->grades.begin());
+        return slice(*c, first, std::max(first, endOfAtLeast(*c, minGrade)));
+    }
+
+    // The k best grades (fewer if the course has fewer entries)
+    Range topK(const CourseKey &course, std::size_t k) const {
+        const CourseGrades *c = find(course);
+        if (!c) return Range();
+        return slice(*c, 0, std::min(k, c->size()));
+    }
+};
+
+#endif // GRADE_INDEX_HPP
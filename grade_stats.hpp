@@ -0,0 +1,229 @@
+#ifndef GRADE_STATS_HPP
+#define GRADE_STATS_HPP
+
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GRADE_STATS_X86 1
+#endif
+
+// ========================
+// Grade statistics kernels
+// One pass over a contiguous array of grades yields count, mean,
+// variance, min, max and a 10-bin histogram ([0,1), [1,2) ... [9,10],
+// out-of-range grades clamp to the end bins).
+//
+// The sums are taken relative to the first grade (shifted data), so the
+// variance does not suffer from cancellation, and partial results from
+// separate chunks merge exactly (Chan et al.), which is how large
+// rosters are split across threads.
+//
+// Kernels: AVX2 (chosen at run time when the CPU has it), SSE2 (always
+// present on x86-64) and a portable scalar loop.
+// ========================
+
+constexpr std::size_t GRADE_HIST_BINS = 10;
+
+struct GradeStats {
+    std::size_t count = 0;
+    double      mean  = 0.0;
+    double      m2    = 0.0;    // sum of squared deviations from mean
+    double      min   = std::numeric_limits<double>::infinity();
+    double      max   = -std::numeric_limits<double>::infinity();
+    std::array<std::size_t, GRADE_HIST_BINS> histogram{};
+
+    // Population variance / standard deviation (0 for fewer than 2 grades)
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+
+    // Folds `o` (stats of a disjoint set of grades) into this one
+    void merge(const GradeStats &o) {
+        if (o.count == 0) return;
+        if (count == 0) {
+            *this = o;
+            return;
+        }
+        const double na = static_cast<double>(count), nb = static_cast<double>(o.count);
+        const double delta = o.mean - mean;
+        const double n = na + nb;
+        mean += delta * nb / n;
+        m2 += o.m2 + delta * delta * na * nb / n;
+        count += o.count;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+        for (std::size_t b = 0; b < GRADE_HIST_BINS; ++b) histogram[b] += o.histogram[b];
+    }
+};
+
+// Kernel implementations; use computeGradeStats() below
+struct GradeKernels {
+    // NaN lands in bin 0, as in the SIMD kernels (max_pd returns its
+    // second operand when either one is NaN)
+    static std::size_t binOf(double g) {
+        if (!(g >= 0.0)) return 0;
+        return static_cast<std::size_t>(std::min(g, double(GRADE_HIST_BINS - 1)));
+    }
+
+    // Shifted sums of g[0..n) -> stats; s1 = sum(g - k), s2 = sum((g - k)^2)
+    static GradeStats finish(std::size_t n, double k, double s1, double s2,
+                             double mn, double mx,
+                             const std::array<std::size_t, GRADE_HIST_BINS> &hist) {
+        GradeStats st;
+        st.count = n;
+        st.mean = k + s1 / static_cast<double>(n);
+        st.m2 = std::max(0.0, s2 - s1 * s1 / static_cast<double>(n));
+        st.min = mn;
+        st.max = mx;
+        st.histogram = hist;
+        return st;
+    }
+
+    static GradeStats scalar(const double *g, std::size_t n) {
+        if (n == 0) return GradeStats();
+        const double k = g[0];
+        double s1 = 0.0, s2 = 0.0, mn = g[0], mx = g[0];
+        std::array<std::size_t, GRADE_HIST_BINS> hist{};
+        for (std::size_t i = 0; i < n; ++i) {
+            const double d = g[i] - k;
+            s1 += d;
+            s2 += d * d;
+            mn = std::min(mn, g[i]);
+            mx = std::max(mx, g[i]);
+            ++hist[binOf(g[i])];
+        }
+        return finish(n, k, s1, s2, mn, mx, hist);
+    }
+
+#ifdef GRADE_STATS_X86
+
+    static GradeStats sse2(const double *g, std::size_t n) {
+        if (n < 2) return scalar(g, n);
+        const double k = g[0];
+        const __m128d vk = _mm_set1_pd(k);
+        const __m128d lo = _mm_setzero_pd(), hi = _mm_set1_pd(double(GRADE_HIST_BINS - 1));
+        __m128d s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd();
+        __m128d mn = _mm_set1_pd(k), mx = _mm_set1_pd(k);
+        std::array<std::size_t, GRADE_HIST_BINS> hist{};
+        alignas(16) std::int32_t bins[4];
+
+        std::size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m128d v = _mm_loadu_pd(g + i);
+            __m128d d = _mm_sub_pd(v, vk);
+            s1 = _mm_add_pd(s1, d);
+            s2 = _mm_add_pd(s2, _mm_mul_pd(d, d));
+            mn = _mm_min_pd(mn, v);
+            mx = _mm_max_pd(mx, v);
+            _mm_store_si128(reinterpret_cast<__m128i *>(bins),
+                            _mm_cvttpd_epi32(_mm_min_pd(_mm_max_pd(v, lo), hi)));
+            ++hist[bins[0]];
+            ++hist[bins[1]];
+        }
+
+        alignas(16) double a1[2], a2[2], amn[2], amx[2];
+        _mm_store_pd(a1, s1);
+        _mm_store_pd(a2, s2);
+        _mm_store_pd(amn, mn);
+        _mm_store_pd(amx, mx);
+        double t1 = a1[0] + a1[1], t2 = a2[0] + a2[1];
+        double tmn = std::min(amn[0], amn[1]), tmx = std::max(amx[0], amx[1]);
+        for (; i < n; ++i) {
+            const double d = g[i] - k;
+            t1 += d;
+            t2 += d * d;
+            tmn = std::min(tmn, g[i]);
+            tmx = std::max(tmx, g[i]);
+            ++hist[binOf(g[i])];
+        }
+        return finish(n, k, t1, t2, tmn, tmx, hist);
+    }
+
+    __attribute__((target("avx2")))
+    static GradeStats avx2(const double *g, std::size_t n) {
+        if (n < 4) return scalar(g, n);
+        const double k = g[0];
+        const __m256d vk = _mm256_set1_pd(k);
+        const __m256d lo = _mm256_setzero_pd(), hi = _mm256_set1_pd(double(GRADE_HIST_BINS - 1));
+        __m256d s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd();
+        __m256d mn = _mm256_set1_pd(k), mx = _mm256_set1_pd(k);
+        std::array<std::size_t, GRADE_HIST_BINS> hist{};
+        alignas(16) std::int32_t bins[4];
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d v = _mm256_loadu_pd(g + i);
+            __m256d d = _mm256_sub_pd(v, vk);
+            s1 = _mm256_add_pd(s1, d);
+            s2 = _mm256_add_pd(s2, _mm256_mul_pd(d, d));
+            mn = _mm256_min_pd(mn, v);
+            mx = _mm256_max_pd(mx, v);
+            _mm_store_si128(reinterpret_cast<__m128i *>(bins),
+                            _mm256_cvttpd_epi32(_mm256_min_pd(_mm256_max_pd(v, lo), hi)));
+            ++hist[bins[0]];
+            ++hist[bins[1]];
+            ++hist[bins[2]];
+            ++hist[bins[3]];
+        }
+
+        alignas(32) double a1[4], a2[4], amn[4], amx[4];
+        _mm256_store_pd(a1, s1);
+        _mm256_store_pd(a2, s2);
+        _mm256_store_pd(amn, mn);
+        _mm256_store_pd(amx, mx);
+        double t1 = (a1[0] + a1[1]) + (a1[2] + a1[3]);
+        double t2 = (a2[0] + a2[1]) + (a2[2] + a2[3]);
+        double tmn = std::min(std::min(amn[0], amn[1]), std::min(amn[2], amn[3]));
+        double tmx = std::max(std::max(amx[0], amx[1]), std::max(amx[2], amx[3]));
+        for (; i < n; ++i) {
+            const double d = g[i] - k;
+            t1 += d;
+            t2 += d * d;
+            tmn = std::min(tmn, g[i]);
+            tmx = std::max(tmx, g[i]);
+            ++hist[binOf(g[i])];
+        }
+        return finish(n, k, t1, t2, tmn, tmx, hist);
+    }
+
+#endif // GRADE_STATS_X86
+
+    using Kernel = GradeStats (*)(const double *, std::size_t);
+
+    struct KernelChoice {
+        Kernel      fn;
+        const char *name;
+    };
+
+    static KernelChoice chooseKernel() {
+#ifdef GRADE_STATS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return {avx2, "avx2"};
+        return {sse2, "sse2"};
+#else
+        return {scalar, "scalar"};
+#endif
+    }
+
+    static const KernelChoice &kernel() {
+        static const KernelChoice choice = chooseKernel();
+        return choice;
+    }
+};
+
+// Statistics of g[0..n) with the best kernel this CPU supports
+inline GradeStats computeGradeStats(const double *g, std::size_t n) {
+    return GradeKernels::kernel().fn(g, n);
+}
+
+// "avx2", "sse2" or "scalar"
+inline const char *gradeStatsKernelName() {
+    return GradeKernels::kernel().name;
+}
+
+#endif // GRADE_STATS_HPP
@@ -0,0 +1,198 @@
+#ifndef GROUP_BY_HPP
+#define GROUP_BY_HPP
+
+#include "column_store.hpp"
+#include "thread_pool.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <functional>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Group-by aggregation
+// Groups rows by any of (branch, start year, course) and aggregates
+// count / sum / avg / min / max of a value. What a "row" is depends on
+// the source:
+//   Students          one row per student, value = CGPA (students with
+//                     no completed course count but carry no value)
+//   CurrentCourses    one row per current enrollment, no value
+//   CompletedCourses  one row per completed course, value = grade
+//
+// Runs over the column store: each pool task folds its slice of rows
+// into a private hash table, and the partial tables are merged once at
+// the end, so no locks or shared writes sit on the hot path.
+// ========================
+
+enum class GroupSource { Students, CurrentCourses, CompletedCourses };
+
+struct GroupBySpec {
+    bool        byBranch = false;
+    bool        byYear   = false;
+    bool        byCourse = false;   // needs a course source
+    GroupSource source   = GroupSource::Students;
+};
+
+template <typename CourseKey>
+struct GroupRow {
+    // Key parts; unused dimensions keep these defaults
+    BranchId  branch = SymbolTable<BranchId>::NONE;
+    int       year   = 0;
+    CourseKey course{};
+
+    std::size_t count  = 0;   // rows in the group
+    std::size_t values = 0;   // rows that carried a value
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    double avg() const { return values ? sum / static_cast<double>(values) : 0.0; }
+
+    void add(double v) {
+        ++values;
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+    }
+
+    void merge(const GroupRow &o) {
+        count += o.count;
+        values += o.values;
+        sum += o.sum;
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+    }
+};
+
+template <typename RollT, typename CourseCodeT>
+class GroupByEngine {
+public:
+    using ColumnStoreT = ColumnStore<RollT, CourseCodeT>;
+    using KeyTraits    = CourseKeyTraits<CourseCodeT>;
+    using CourseKey    = typename KeyTraits::Key;
+    using Row          = GroupRow<CourseKey>;
+
+private:
+    struct Key {
+        BranchId  branch;
+        int       year;
+        CourseKey course;
+
+        bool operator==(const Key &o) const {
+            return branch == o.branch && year == o.year && course == o.course;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &k) const {
+            std::uint64_t h = (std::uint64_t(k.branch) << 32) ^ std::uint32_t(k.year);
+            h = h * 0x9E3779B97F4A7C15ULL ^ std::hash<CourseKey>()(k.course);
+            return static_cast<std::size_t>(h ^ (h >> 29));
+        }
+    };
+
+    using Table = std::unordered_map<Key, Row, KeyHash>;
+
+    const ColumnStoreT &cols;
+    GroupBySpec spec;
+
+    Row &slot(Table &t, std::size_t r, CourseKey course) const {
+        Key k{spec.byBranch ? cols.branches()[r] : SymbolTable<BranchId>::NONE,
+              spec.byYear ? static_cast<int>(cols.startYears()[r]) : 0,
+              spec.byCourse ? course : CourseKey{}};
+        Row &row = t[k];
+        if (row.count == 0) {
+            row.branch = k.branch;
+            row.year = k.year;
+            row.course = k.course;
+        }
+        return row;
+    }
+
+    // Folds column row `r` into `t`
+    void fold(Table &t, std::size_t r) const {
+        switch (spec.source) {
+        case GroupSource::Students: {
+            const auto &off = cols.completedCourseOffsets();
+            const auto &grades = cols.completedCourseGrades();
+            Row &row = slot(t, r, CourseKey{});
+            ++row.count;
+            if (off[r] == off[r + 1]) break;
+            double sum = 0.0;
+            for (std::size_t k = off[r]; k < off[r + 1]; ++k) sum += grades[k];
+            row.add(sum / static_cast<double>(off[r + 1] - off[r]));
+            break;
+        }
+        case GroupSource::CurrentCourses: {
+            const auto &off = cols.currentCourseOffsets();
+            const auto &courses = cols.currentCourseKeys();
+            for (std::size_t k = off[r]; k < off[r + 1]; ++k) ++slot(t, r, courses[k]).count;
+            break;
+        }
+        case GroupSource::CompletedCourses: {
+            const auto &off = cols.completedCourseOffsets();
+            const auto &courses = cols.completedCourseKeys();
+            const auto &grades = cols.completedCourseGrades();
+            for (std::size_t k = off[r]; k < off[r + 1]; ++k) {
+                Row &row = slot(t, r, courses[k]);
+                ++row.count;
+                row.add(grades[k]);
+            }
+            break;
+        }
+        }
+    }
+
+public:
+    GroupByEngine(const ColumnStoreT &cols, const GroupBySpec &spec) : cols(cols), spec(spec) {
+        if (spec.byCourse && spec.source == GroupSource::Students)
+            throw std::invalid_argument("group by course needs a course source");
+    }
+
+    // Groups the column rows listed in `rows` (all rows if null), sorted
+    // by branch name, then year, then course code
+    std::vector<Row> run(ThreadPool &pool, const std::vector<std::size_t> *rows = nullptr) const {
+        const std::size_t n = rows ? rows->size() : cols.size();
+        const std::size_t chunkSize = 64 * 1024;
+        const std::size_t chunks = (n + chunkSize - 1) / chunkSize;
+
+        std::vector<Table> partial(chunks);
+        pool.parallelFor(chunks, [&](std::size_t c) {
+            Table &t = partial[c];
+            std::size_t end = std::min(n, (c + 1) * chunkSize);
+            for (std::size_t i = c * chunkSize; i < end; ++i)
+                fold(t, rows ? (*rows)[i] : i);
+        });
+
+        Table all;
+        for (auto &t : partial) {
+            for (auto &kv : t) {
+                auto it = all.find(kv.first);
+                if (it == all.end()) all.emplace(kv.first, kv.second);
+                else it->second.merge(kv.second);
+            }
+        }
+
+        std::vector<Row> out;
+        out.reserve(all.size());
+        for (auto &kv : all) out.push_back(kv.second);
+
+        const auto &branches = branchSymbols();
+        std::sort(out.begin(), out.end(), [&branches](const Row &a, const Row &b) {
+            if (a.branch != b.branch) {
+                if (a.branch == SymbolTable<BranchId>::NONE) return true;
+                if (b.branch == SymbolTable<BranchId>::NONE) return false;
+                return branches.name(a.branch) < branches.name(b.branch);
+            }
+            if (a.year != b.year) return a.year < b.year;
+            return KeyTraits::less(a.course, b.course);
+        });
+        return out;
+    }
+};
+
+#endif // GROUP_BY_HPP
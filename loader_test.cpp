@@ -0,0 +1,166 @@
+// loader_test.cpp
+// Loads the same CSV files through loadFromCSV, loadFromCSVMapped and
+// loadFromCSVParallel and checks that all three produce the same records
+// and the same loaded / skipped counts. Exits non-zero on a mismatch.
+//
+//   make test
+
+#include "student.hpp"
+#include "database.hpp"
+#include "generator.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdio>
+
+// ---------------- RECORDS ----------------
+// One line of text per student: every field, courses and grades in order
+template <typename DB>
+static std::vector<std::string> records(const DB &db) {
+    std::vector<std::string> out;
+    for (const auto &s : db.getStudents()) {
+        std::ostringstream os;
+        os << s.getName() << '|' << s.getRoll() << '|' << s.getBranch() << '|'
+           << s.getStartYear() << '|';
+        for (const auto &c : s.getCurrentCourses()) os << c << ';';
+        os << '|';
+        for (const auto &p : s.getCompletedCourses()) os << p.first << ':' << p.second << ';';
+        out.push_back(os.str());
+    }
+    return out;
+}
+
+struct LoadResult {
+    std::string              path;
+    bool                     ok = false;
+    std::size_t              loaded = 0, skipped = 0;
+    std::vector<std::string> rows;
+};
+
+template <typename DB>
+static bool checkFile(const std::string &label, const std::string &file,
+                      std::size_t expectLoaded) {
+    using Loader = std::function<bool(DB &)>;
+    const std::vector<std::pair<std::string, Loader>> loaders = {
+        {"loadFromCSV",         [&](DB &db) { return db.loadFromCSV(file); }},
+        {"loadFromCSVMapped",   [&](DB &db) { return db.loadFromCSVMapped(file); }},
+        {"loadFromCSVParallel", [&](DB &db) { return db.loadFromCSVParallel(file, 4); }},
+    };
+
+    // The loaders report every skipped row; keep the test output short
+    std::ostringstream skipped;
+    std::streambuf *cerrBuf = std::cerr.rdbuf(skipped.rdbuf());
+    std::vector<LoadResult> results;
+    for (const auto &l : loaders) {
+        DB db;
+        LoadResult r;
+        r.path = l.first;
+        r.ok = l.second(db);
+        r.loaded = db.getLastLoadStats().rowsLoaded;
+        r.skipped = db.getLastLoadStats().rowsSkipped;
+        r.rows = records(db);
+        results.push_back(std::move(r));
+    }
+    std::cerr.rdbuf(cerrBuf);
+
+    bool pass = true;
+    const LoadResult &ref = results.front();
+    if (!ref.ok || ref.rows.size() != expectLoaded || ref.loaded != expectLoaded) {
+        std::cerr << "FAIL " << label << ": " << ref.path << " loaded " << ref.rows.size()
+                  << " rows, expected " << expectLoaded << "\n";
+        pass = false;
+    }
+    for (std::size_t i = 1; i < results.size(); ++i) {
+        const LoadResult &r = results[i];
+        if (r.ok != ref.ok || r.loaded != ref.loaded || r.skipped != ref.skipped ||
+            r.rows != ref.rows) {
+            std::cerr << "FAIL " << label << ": " << r.path << " (" << r.loaded << " loaded, "
+                      << r.skipped << " skipped) differs from " << ref.path << " ("
+                      << ref.loaded << " loaded, " << ref.skipped << " skipped)\n";
+            for (std::size_t k = 0; k < std::max(r.rows.size(), ref.rows.size()); ++k) {
+                const std::string a = k < ref.rows.size() ? ref.rows[k] : "-";
+                const std::string b = k < r.rows.size() ? r.rows[k] : "-";
+                if (a != b) {
+                    std::cerr << "  row " << k << ": " << a << "  vs  " << b << "\n";
+                    break;
+                }
+            }
+            pass = false;
+        }
+    }
+    if (pass) std::cout << "ok   " << label << " (" << ref.loaded << " loaded, "
+                        << ref.skipped << " skipped)\n";
+    return pass;
+}
+
+// ---------------- CASES ----------------
+static bool writeFile(const std::string &path, const std::string &text) {
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+    return static_cast<bool>(out);
+}
+
+// Rows at the edges of the field rules: signs, trailing text after a
+// number, non-finite grades, bad keys, missing fields, CRLF, blanks
+static const char *EDGE_CSV =
+    "name,roll,branch,startYear,currentCourses,completedCourses\n"
+    "plain,1001,cse,2021,ml;oopd,12345:9.5;ga:7\n"
+    "plusyear,1002,cse,+2021,ml,12345:8\n"
+    "fracyear,1003,ece,2021.0,,\n"
+    "plusgrade,1004,cse,2022,,12345:+9.5\n"
+    "junkgrade,1005,cse,2022,,12345:9.5x\n"
+    "negyear,1006,csb,-1,ml,\n"
+    "nangrade,1007,cse,2022,,12345:nan\n"
+    "infgrade,1008,cse,2022,,12345:inf\n"
+    "badyear,1009,cse,year,ml,\n"
+    "hugeyear,1010,cse,99999999999,ml,\n"
+    "nocolon,1011,cse,2022,ml,12345\n"
+    "short,1012,cse\n"
+    "\n"
+    "  spaced  , 1013 , cse , 2023 , ml ; oopd , 12345 : 6.5 \n"
+    "crlf,1014,cse,2020,ml,12345:7.25\r\n"
+    "emptyroll,,cse,2020,,\n"
+    "lastrow,1015,cse,2024,ml,12345:10";
+
+// Rows only the numeric key types reject
+static const char *NUMERIC_CSV =
+    "name,roll,branch,startYear,currentCourses,completedCourses\n"
+    "ok,2001,cse,2021,101;102,201:9\n"
+    "rollword,r2002,cse,2021,101,201:9\n"
+    "coursejunk,2003,cse,2021,101x,201:9\n"
+    "gradecourse,2004,cse,2021,101,2o1:9\n"
+    "plusyear,2005,cse,+2021,101,201:+8.5\n";
+
+int main() {
+    const std::string edge = "loader_test_edge.csv";
+    const std::string numeric = "loader_test_numeric.csv";
+    const std::string generated = "loader_test_generated.csv";
+    bool pass = writeFile(edge, EDGE_CSV) && writeFile(numeric, NUMERIC_CSV);
+
+    GeneratorOptions gen;
+    gen.rows = 20000;
+    gen.seed = 7;
+    gen.numericCourses = true;
+    pass = DatasetGenerator(gen).write(generated) && pass;
+    if (!pass) {
+        std::cerr << "Cannot write the test CSVs.\n";
+        return 1;
+    }
+
+    using StringDB  = StudentDatabase<std::string, std::string>;
+    using NumericDB = StudentDatabase<unsigned int, int>;
+    pass = checkFile<StringDB>("edge rows, string keys", edge, 11) && pass;
+    pass = checkFile<NumericDB>("edge rows, numeric keys", edge, 3) && pass;
+    pass = checkFile<StringDB>("numeric rows, string keys", numeric, 5) && pass;
+    pass = checkFile<NumericDB>("numeric rows, numeric keys", numeric, 2) && pass;
+    pass = checkFile<StringDB>("generated, string keys", generated, gen.rows) && pass;
+    pass = checkFile<NumericDB>("generated, numeric keys", generated, gen.rows) && pass;
+
+    for (const auto &f : {edge, numeric, generated}) std::remove(f.c_str());
+    std::cout << (pass ? "All loaders agree.\n" : "Loaders disagree.\n");
+    return pass ? 0 : 1;
+}
@@ -1,393 +1,995 @@
-#include "student.hpp"
-#include "database.hpp"
-
-#include <iostream>
-#include <limits>
-#include <fstream>
-#include <vector>
-#include <cctype>
-#include <stdexcept>
-#include <sstream>
-
-using IIITStudent   = Student<std::string, std::string>;
-using IIITDatabase  = StudentDatabase<std::string, std::string>;
-using IITStudent    = Student<unsigned int, int>;
-
-const std::string CSV_FILE = "oopd_students.csv";
-
-// ---------------- VALIDATION ----------------
-void validateStudentName(const std::string &name) {
-    if (name.empty())
-        throw std::invalid_argument("Name cannot be empty.");
-
-    for (char c : name) {
-        if (!std::isalpha(static_cast<unsigned char>(c)) &&
-            !std::isspace(static_cast<unsigned char>(c)))
-            throw std::invalid_argument("Name must contain only alphabets and spaces.");
-    }
-}
-
-bool isAlphabetic(const std::string &str) {
-    if (str.empty()) return false;
-    for (char c : str)
-        if (!std::isalpha(static_cast<unsigned char>(c))) return false;
-    return true;
-}
-
-bool isNumeric(const std::string &str) {
-    if (str.empty()) return false;
-    for (char c : str)
-        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
-    return true;
-}
-
-std::string toUpper(const std::string &s) {
-    std::string res = s;
-    for (char &ch : res) {
-        ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-    }
-    return res;
-}
-
-// -------- OOPD CHECK (for filtering only) --------
-bool studentHasCourseOOPD(const IIITStudent &s) {
-    const std::string oopd = "OOPD";
-
-    // Check current courses (case-insensitive)
-    for (const auto &c : s.getCurrentCourses()) {
-        if (toUpper(c) == oopd) return true;
-    }
-
-    // Check completed courses (keys), case-insensitive
-    const auto &completed = s.getCompletedCourses();
-    for (const auto &p : completed) {
-        if (toUpper(p.first) == oopd) return true;
-    }
-
-    return false;
-}
-
-// -------------- CSV APPEND (with courses + grades) ----------------
-void appendStudentsToCSV(const std::string &filename,
-                         const std::vector<IIITStudent> &students)
-{
-    bool exists = false, empty = true;
-
-    {
-        std::ifstream chk(filename);
-        if (chk.good()) {
-            exists = true;
-            chk.seekg(0, std::ios::end);
-            empty = (chk.tellg() == 0);
-        }
-    }
-
-    std::ofstream out(filename, std::ios::app);
-    if (!out) {
-        std::cerr << "Error opening CSV.\n";
-        return;
-    }
-
-    if (!exists || empty)
-        out << "name,roll,branch,startYear,currentCourses,completedCourses\n";
-
-    for (const auto &s : students) {
-        std::string currentStr, compStr;
-
-        for (const auto &c : s.getCurrentCourses()) {
-            if (!currentStr.empty()) currentStr += ";";
-            currentStr += c;
-        }
-
-        for (const auto &p : s.getCompletedCourses()) {
-            if (!compStr.empty()) compStr += ";";
-            compStr += p.first + ":" + std::to_string(p.second);
-        }
-
-        out << s.getName()           << ","
-            << s.getRoll()           << ","
-            << s.getBranch()         << ","
-            << s.getStartYear()      << ","
-            << currentStr            << ","
-            << compStr               << "\n";
-    }
-
-    std::cout << "\nSaved " << students.size() << " students to CSV.\n";
-}
-
-// -------------- CLEAR CSV ----------------
-void clearCSV(const std::string &filename, IIITDatabase &db) {
-    char c;
-    std::cout << "Are you sure you want to clear CSV? (y/n): ";
-    std::cin >> c;
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-
-    if (c == 'y' || c == 'Y') {
-        std::ofstream out(filename, std::ios::trunc);
-        db = IIITDatabase();
-        std::cout << "\nCSV cleared and memory reset.\n";
-    } else {
-        std::cout << "Cancelled.\n";
-    }
-}
-
-// -------------- MANUAL ENTRY ----------------
-void addStudentsManually(IIITDatabase &db) {
-    int n;
-    std::cout << "\nHow many students? ";
-    while (!(std::cin >> n) || n <= 0) {
-        std::cin.clear(); std::cin.ignore(10000, '\n');
-        std::cout << "Enter valid number: ";
-    }
-    std::cin.ignore(10000, '\n');
-
-    std::vector<IIITStudent> newStudents;
-
-    for (int i = 0; i < n; i++) {
-        std::cout << "\n---- Student " << (i+1) << " ----\n";
-
-        std::string name, roll, branch;
-        int startYear;
-
-        while (true) {
-            std::cout << "Enter Name: ";
-            std::getline(std::cin, name);
-            try { validateStudentName(name); break; }
-            catch (const std::invalid_argument &e) { std::cout << e.what() << "\n"; }
-        }
-
-        std::cout << "Enter Roll: ";
-        std::getline(std::cin, roll);
-
-        std::cout << "Enter Branch: ";
-        std::getline(std::cin, branch);
-
-        std::cout << "Enter Start Year: ";
-        while (!(std::cin >> startYear)) {
-            std::cin.clear(); std::cin.ignore(10000, '\n');
-            std::cout << "Enter valid integer: ";
-        }
-        std::cin.ignore(10000, '\n');
-
-        IIITStudent stud(name, roll, branch, startYear);
-
-        // ---------- CURRENT COURSES ----------
-        int cur;
-        std::cout << "Number of CURRENT courses: ";
-        while (!(std::cin >> cur) || cur < 0) {
-            std::cin.clear(); std::cin.ignore(10000, '\n');
-            std::cout << "Enter valid integer: ";
-        }
-        std::cin.ignore(10000, '\n');
-
-        for (int j = 0; j < cur; j++) {
-            int type;
-            std::string course;
-
-            while (true) {
-                std::cout << "\nCurrent Course " << (j+1)
-                          << " | Type (1=IIITD , 2=IITD): ";
-
-                if (!(std::cin >> type)) {
-                    std::cin.clear(); std::cin.ignore(10000, '\n');
-                    std::cout << "Enter valid integer.\n"; continue;
-                }
-                if (type != 1 && type != 2) {
-                    std::cin.ignore(10000, '\n');
-                    std::cout << "Enter 1 or 2.\n"; continue;
-                }
-                std::cin.ignore(10000, '\n');
-
-                std::cout << "Course Code: ";
-                std::getline(std::cin, course);
-
-                if (type == 1 && !isAlphabetic(course)) {
-                    std::cout << "IIITD course must be alphabets only.\n"; continue;
-                }
-                if (type == 2 && !isNumeric(course)) {
-                    std::cout << "IITD course must be integers only.\n"; continue;
-                }
-                break;
-            }
-            stud.enrollInCourse(course);
-        }
-
-        // ---------- COMPLETED COURSES ----------
-        int comp;
-        std::cout << "Number of COMPLETED courses: ";
-        while (!(std::cin >> comp) || comp < 0) {
-            std::cin.clear(); std::cin.ignore(10000, '\n');
-            std::cout << "Enter valid integer: ";
-        }
-        std::cin.ignore(10000, '\n');
-
-        for (int j = 0; j < comp; j++) {
-            int type; std::string course; double grade;
-
-            while (true) {
-                std::cout << "\nCompleted Course " << (j+1)
-                          << " | Type (1=IIITD , 2=IITD): ";
-
-                if (!(std::cin >> type)) {
-                    std::cin.clear(); std::cin.ignore(10000, '\n');
-                    std::cout << "Enter valid integer.\n"; continue;
-                }
-                if (type != 1 && type != 2) {
-                    std::cout << "Enter 1 or 2.\n"; continue;
-                }
-                std::cin.ignore(10000, '\n');
-
-                std::cout << "Course Code: ";
-                std::getline(std::cin, course);
-
-                if (type == 1 && !isAlphabetic(course)) {
-                    std::cout << "IIITD must be alphabets.\n"; continue;
-                }
-                if (type == 2 && !isNumeric(course)) {
-                    std::cout << "IITD must be integers.\n"; continue;
-                }
-                break;
-            }
-
-            std::cout << "Grade: ";
-            while (!(std::cin >> grade)) {
-                std::cin.clear(); std::cin.ignore(10000, '\n');
-                std::cout << "Enter numeric grade: ";
-            }
-            std::cin.ignore(10000, '\n');
-
-            stud.completeCourse(course, grade);
-        }
-
-        // ✅ No automatic OOPD addition here
-        db.addStudent(stud);
-        newStudents.push_back(stud);
-    }
-
-    appendStudentsToCSV(CSV_FILE, newStudents);
-}
-
-// -------------- OOPD DISPLAY (FILTER ONLY) ----------------
-void showOOPDStudents(const IIITDatabase &db) {
-    std::cout << "\n===== OOPD STUDENTS (IIIT-Delhi) =====\n";
-    const auto &all = db.getStudents();
-    bool found = false;
-
-    for (const auto &s : all) {
-        if (studentHasCourseOOPD(s)) {
-            found = true;
-            std::cout << s << "\n";
-        }
-    }
-
-    if (!found) std::cout << "No OOPD students found.\n";
-}
-
-// ---------------- MENU ----------------
-void showMenu() {
-    std::cout << "\n========== MENU ==========\n";
-    std::cout << "1. Load CSV\n";
-    std::cout << "2. Add students manually\n";
-    std::cout << "3. Show original records\n";
-    std::cout << "4. Sort by roll using threads\n";
-    std::cout << "5. Show sorted records\n";
-    std::cout << "6. Query grade >= 9\n";
-    std::cout << "7. Clear CSV\n";
-    std::cout << "8. Show OOPD students (IIIT-Delhi)\n";
-    std::cout << "0. Exit\n";
-    std::cout << "==========================\n";
-    std::cout << "Enter option: ";
-}
-
-// ---------------- MAIN ----------------
-int main() {
-    IIITDatabase db;
-    bool running = true;
-    bool sorted = false;
-
-    while (running) {
-        showMenu();
-
-        int choice;
-        if (!(std::cin >> choice)) {
-            std::cin.clear(); std::cin.ignore(10000, '\n');
-            continue;
-        }
-        std::cin.ignore(10000, '\n');
-
-        switch (choice) {
-
-        case 1:
-            db.loadFromCSV(CSV_FILE);
-            std::cout << "Loaded. Total: " << db.getStudents().size() << "\n";
-            break;
-
-        case 2:
-            addStudentsManually(db);
-            break;
-
-        case 3:
-            db.showOriginalOrder();
-            break;
-
-        case 4: {
-            std::size_t t;
-            std::cout << "Threads (>=2 required): ";
-            while (!(std::cin >> t)) {
-                std::cin.clear(); std::cin.ignore(10000, '\n');
-                std::cout << "Enter integer value: ";
-            }
-            std::cin.ignore(10000, '\n');
-
-            if (t < 2) {
-                std::cout << "Using 2 threads (minimum).\n";
-                t = 2;
-            }
-
-            db.parallelSortByRoll(t);
-            sorted = true;
-            break;
-        }
-
-        case 5:
-            if (!sorted) std::cout << "Sort first!\n";
-            else db.showSortedOrder();
-            break;
-
-        case 6: {
-            std::string course;
-            std::cout << "Course to search (>=9): ";
-            std::getline(std::cin, course);
-
-            db.buildGradeIndex();
-            auto result = db.queryByCourseAndMinGrade(course, 9.0);
-
-            if (result.empty()) std::cout << "None found.\n";
-            else {
-                std::cout << "Students with grade >=9:\n";
-                for (auto s : result) std::cout << *s << "\n";
-            }
-            break;
-        }
-
-        case 7:
-            clearCSV(CSV_FILE, db);
-            sorted = false;
-            break;
-
-        case 8:
-            showOOPDStudents(db);
-            break;
-
-        case 0:
-            running = false;
-            break;
-
-        default:
-            std::cout << "Invalid choice.\n";
-        }
-    }
-
-    std::cout << "Exiting...\n";
-    return 0;
-}
+#include "student.hpp"
+#include "database.hpp"
+#include "csv_log.hpp"
+#include "external_sort.hpp"
+#include "versioned_database.hpp"
+#include "server.hpp"
+#include "batch.hpp"
+
+#include <iostream>
+#include <limits>
+#include <fstream>
+#include <vector>
+#include <cctype>
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <csignal>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+using IIITStudent   = Student<std::string, std::string>;
+using IIITDatabase  = StudentDatabase<std::string, std::string>;
+using IITStudent    = Student<unsigned int, int>;
+using IITDatabase   = StudentDatabase<unsigned int, int>;
+
+// Numeric rolls and course codes: parsed straight into integers, with the
+// direct-addressed roll and course indexes and the radix sort. Instantiated
+// in full so every member keeps compiling for integral keys.
+template class StudentDatabase<unsigned int, int>;
+
+const std::string CSV_FILE      = "oopd_students.csv";
+const std::string SNAPSHOT_FILE = "oopd_students.snap";
+const std::string SORTED_FILE   = "oopd_students_by_roll.csv";
+const std::string SOCKET_FILE   = "oopd_students.sock";
+
+// ---------------- VALIDATION ----------------
+void validateStudentName(const std::string &name) {
+    if (name.empty())
+        throw std::invalid_argument("Name cannot be empty.");
+
+    for (char c : name) {
+        if (!std::isalpha(static_cast<unsigned char>(c)) &&
+            !std::isspace(static_cast<unsigned char>(c)))
+            throw std::invalid_argument("Name must contain only alphabets and spaces.");
+    }
+}
+
+bool isAlphabetic(const std::string &str) {
+    if (str.empty()) return false;
+    for (char c : str)
+        if (!std::isalpha(static_cast<unsigned char>(c))) return false;
+    return true;
+}
+
+bool isNumeric(const std::string &str) {
+    if (str.empty()) return false;
+    for (char c : str)
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    return true;
+}
+
+// -------------- CSV APPEND (group commit, see csv_log.hpp) ----------------
+void appendStudentsToCSV(CsvAppendLog &log, const std::vector<IIITStudent> &students) {
+    for (const auto &s : students) log.append(s);
+    if (!log.commit()) {
+        std::cerr << "Error writing CSV.\n";
+        return;
+    }
+    std::cout << "\nSaved " << students.size() << " students to CSV.\n";
+}
+
+// -------------- CSV ROW REWRITE (edit / delete) ----------------
+// Changes only the row for `roll` in the file (the first one the loaders
+// accept, i.e. the one that was loaded); the rest of the file is kept
+// whether or not it was loaded. `updated` null deletes the row.
+bool rewriteCSVRow(CsvAppendLog &log, const std::string &roll, const IIITStudent *updated) {
+    if (log.rewriteRow(roll, updated, IIITDatabase::isValidCSVRow)) return true;
+    std::cerr << "Could not update roll " << roll << " in " << CSV_FILE
+              << "; nothing was changed.\n";
+    return false;
+}
+
+// -------------- CLEAR CSV ----------------
+void clearCSV(CsvAppendLog &log, IIITDatabase &db) {
+    char c;
+    std::cout << "Are you sure you want to clear CSV? (y/n): ";
+    std::cin >> c;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+
+    if (c == 'y' || c == 'Y') {
+        log.truncate();
+        db = IIITDatabase();
+        std::cout << "\nCSV cleared and memory reset.\n";
+    } else {
+        std::cout << "Cancelled.\n";
+    }
+}
+
+// -------------- MANUAL ENTRY ----------------
+void addStudentsManually(IIITDatabase &db, CsvAppendLog &log) {
+    int n;
+    std::cout << "\nHow many students? ";
+    while (!(std::cin >> n) || n <= 0) {
+        std::cin.clear(); std::cin.ignore(10000, '\n');
+        std::cout << "Enter valid number: ";
+    }
+    std::cin.ignore(10000, '\n');
+
+    std::vector<IIITStudent> newStudents;
+
+    for (int i = 0; i < n; i++) {
+        std::cout << "\n---- Student " << (i+1) << " ----\n";
+
+        std::string name, roll, branch;
+        int startYear;
+
+        while (true) {
+            std::cout << "Enter Name: ";
+            std::getline(std::cin, name);
+            try { validateStudentName(name); break; }
+            catch (const std::invalid_argument &e) { std::cout << e.what() << "\n"; }
+        }
+
+        std::cout << "Enter Roll: ";
+        std::getline(std::cin, roll);
+
+        std::cout << "Enter Branch: ";
+        std::getline(std::cin, branch);
+
+        std::cout << "Enter Start Year: ";
+        while (!(std::cin >> startYear)) {
+            std::cin.clear(); std::cin.ignore(10000, '\n');
+            std::cout << "Enter valid integer: ";
+        }
+        std::cin.ignore(10000, '\n');
+
+        IIITStudent stud(name, roll, branch, startYear);
+
+        // ---------- CURRENT COURSES ----------
+        int cur;
+        std::cout << "Number of CURRENT courses: ";
+        while (!(std::cin >> cur) || cur < 0) {
+            std::cin.clear(); std::cin.ignore(10000, '\n');
+            std::cout << "Enter valid integer: ";
+        }
+        std::cin.ignore(10000, '\n');
+
+        for (int j = 0; j < cur; j++) {
+            int type;
+            std::string course;
+
+            while (true) {
+                std::cout << "\nCurrent Course " << (j+1)
+                          << " | Type (1=IIITD , 2=IITD): ";
+
+                if (!(std::cin >> type)) {
+                    std::cin.clear(); std::cin.ignore(10000, '\n');
+                    std::cout << "Enter valid integer.\n"; continue;
+                }
+                if (type != 1 && type != 2) {
+                    std::cin.ignore(10000, '\n');
+                    std::cout << "Enter 1 or 2.\n"; continue;
+                }
+                std::cin.ignore(10000, '\n');
+
+                std::cout << "Course Code: ";
+                std::getline(std::cin, course);
+
+                if (type == 1 && !isAlphabetic(course)) {
+                    std::cout << "IIITD course must be alphabets only.\n"; continue;
+                }
+                if (type == 2 && !isNumeric(course)) {
+                    std::cout << "IITD course must be integers only.\n"; continue;
+                }
+                break;
+            }
+            stud.enrollInCourse(course);
+        }
+
+        // ---------- COMPLETED COURSES ----------
+        int comp;
+        std::cout << "Number of COMPLETED courses: ";
+        while (!(std::cin >> comp) || comp < 0) {
+            std::cin.clear(); std::cin.ignore(10000, '\n');
+            std::cout << "Enter valid integer: ";
+        }
+        std::cin.ignore(10000, '\n');
+
+        for (int j = 0; j < comp; j++) {
+            int type; std::string course; double grade;
+
+            while (true) {
+                std::cout << "\nCompleted Course " << (j+1)
+                          << " | Type (1=IIITD , 2=IITD): ";
+
+                if (!(std::cin >> type)) {
+                    std::cin.clear(); std::cin.ignore(10000, '\n');
+                    std::cout << "Enter valid integer.\n"; continue;
+                }
+                if (type != 1 && type != 2) {
+                    std::cout << "Enter 1 or 2.\n"; continue;
+                }
+                std::cin.ignore(10000, '\n');
+
+                std::cout << "Course Code: ";
+                std::getline(std::cin, course);
+
+                if (type == 1 && !isAlphabetic(course)) {
+                    std::cout << "IIITD must be alphabets.\n"; continue;
+                }
+                if (type == 2 && !isNumeric(course)) {
+                    std::cout << "IITD must be integers.\n"; continue;
+                }
+                break;
+            }
+
+            std::cout << "Grade: ";
+            while (!(std::cin >> grade)) {
+                std::cin.clear(); std::cin.ignore(10000, '\n');
+                std::cout << "Enter numeric grade: ";
+            }
+            std::cin.ignore(10000, '\n');
+
+            stud.completeCourse(course, grade);
+        }
+
+        // ✅ No automatic OOPD addition here
+        db.addStudent(stud);
+        newStudents.push_back(stud);
+    }
+
+    appendStudentsToCSV(log, newStudents);
+}
+
+// -------------- SORT TIMINGS ----------------
+void printSortTimings(const IIITDatabase &db) {
+    const SortTimings &timings = db.getLastSortTimings();
+    const ThreadPool &workers = db.getThreadPool();
+
+    std::cout << "\nThread timing (parallel sort, " << timings.blocks.size()
+              << " blocks on " << workers.size() << " pool workers):\n";
+    for (std::size_t i = 0; i < timings.blocks.size(); ++i) {
+        auto [segStart, segEnd] = timings.blocks[i];
+        std::cout << "  Task " << i << " sorted block ["
+                  << segStart << ", " << segEnd << ") in "
+                  << timings.blockMicros[i] << " microseconds\n";
+    }
+    std::cout << "  Block sort phase ("
+              << (timings.radix ? "radix" : "comparison") << "): "
+              << timings.blockPhaseMicros << " microseconds\n";
+    for (std::size_t l = 0; l < timings.mergeLevelMicros.size(); ++l) {
+        std::cout << "  Merge level " << l << " ("
+                  << timings.mergesPerLevel[l] << " merges): "
+                  << timings.mergeLevelMicros[l] << " microseconds\n";
+    }
+    std::cout << "  Merge phase (parallel tree merge): "
+              << timings.mergePhaseMicros << " microseconds\n";
+
+    auto stats = workers.stats();
+    for (std::size_t w = 0; w < stats.size(); ++w) {
+        std::cout << "  Worker " << w << ": busy " << stats[w].busyMicros
+                  << " microseconds, idle " << stats[w].idleMicros
+                  << " microseconds, " << stats[w].tasks << " tasks ("
+                  << stats[w].steals << " stolen)\n";
+    }
+}
+
+// -------------- OOPD DISPLAY (FILTER ONLY) ----------------
+// Current or completed, any letter case; answered by the enrollment
+// bitmap index rather than a scan
+void showOOPDStudents(IIITDatabase &db) {
+    std::cout << "\n===== OOPD STUDENTS (IIIT-Delhi) =====\n";
+    const auto &all = db.getStudents();
+
+    RowBitmap matches = db.studentsWithCourse("OOPD");
+    matches.forEach([&all](std::size_t i) { std::cout << all[i] << "\n"; });
+
+    if (matches.empty()) std::cout << "No OOPD students found.\n";
+}
+
+// -------------- COURSE FILTER (AND / OR) ----------------
+void filterByCourses(IIITDatabase &db) {
+    std::string line;
+    std::cout << "Courses (space separated): ";
+    std::getline(std::cin, line);
+
+    std::vector<std::string> courses;
+    std::stringstream ss(line);
+    for (std::string c; ss >> c;) courses.push_back(c);
+    if (courses.empty()) {
+        std::cout << "No courses given.\n";
+        return;
+    }
+
+    int mode;
+    std::cout << "Match (1=all, 2=any): ";
+    while (!(std::cin >> mode) || (mode != 1 && mode != 2)) {
+        std::cin.clear(); std::cin.ignore(10000, '\n');
+        std::cout << "Enter 1 or 2: ";
+    }
+
+    int list;
+    std::cout << "Look in (1=current, 2=completed, 3=either): ";
+    while (!(std::cin >> list) || list < 1 || list > 3) {
+        std::cin.clear(); std::cin.ignore(10000, '\n');
+        std::cout << "Enter 1, 2 or 3: ";
+    }
+    std::cin.ignore(10000, '\n');
+
+    const CourseRole role = list == 1 ? CourseRole::Current
+                          : list == 2 ? CourseRole::Completed
+                                      : CourseRole::Any;
+    RowBitmap rows = mode == 1 ? db.studentsWithAllCourses(courses, role)
+                               : db.studentsWithAnyCourse(courses, role);
+
+    const auto &all = db.getStudents();
+    rows.forEach([&all](std::size_t i) { std::cout << all[i] << "\n"; });
+    std::cout << rows.cardinality() << " students matched.\n";
+}
+
+// -------------- FIND / EDIT / DELETE BY ROLL ----------------
+void findStudentByRoll(const IIITDatabase &db) {
+    std::string roll;
+    std::cout << "Roll: ";
+    std::getline(std::cin, roll);
+
+    const IIITStudent *s = db.findByRoll(roll);
+    if (!s) std::cout << "No student with roll " << roll << ".\n";
+    else db.printStudentDetailed(*s);
+}
+
+// Blank answers keep the current value; courses are left unchanged
+void editStudent(IIITDatabase &db, CsvAppendLog &log) {
+    std::string roll;
+    std::cout << "Roll: ";
+    std::getline(std::cin, roll);
+
+    const IIITStudent *cur = db.findByRoll(roll);
+    if (!cur) {
+        std::cout << "No student with roll " << roll << ".\n";
+        return;
+    }
+    db.printStudentDetailed(*cur);
+
+    std::string name, branch, yearStr;
+    while (true) {
+        std::cout << "New name (blank = keep): ";
+        std::getline(std::cin, name);
+        if (name.empty()) { name = cur->getName(); break; }
+        try { validateStudentName(name); break; }
+        catch (const std::invalid_argument &e) { std::cout << e.what() << "\n"; }
+    }
+
+    std::cout << "New branch (blank = keep): ";
+    std::getline(std::cin, branch);
+    if (branch.empty()) branch = cur->getBranch();
+
+    int startYear = cur->getStartYear();
+    while (true) {
+        std::cout << "New start year (blank = keep): ";
+        std::getline(std::cin, yearStr);
+        if (yearStr.empty()) break;
+        if (isNumeric(yearStr)) { startYear = std::stoi(yearStr); break; }
+        std::cout << "Enter valid integer.\n";
+    }
+
+    IIITStudent updated(name, roll, branch, startYear);
+    for (auto c : cur->getCurrentCourseKeys()) updated.enrollInCourseKey(c);
+    for (const auto &p : cur->getCompletedCourseKeys())
+        updated.completeCourseKey(p.first, p.second);
+
+    // File first: memory only changes once the CSV has
+    if (!rewriteCSVRow(log, roll, &updated)) return;
+    db.updateStudent(roll, updated);
+    std::cout << "Updated.\n";
+}
+
+void deleteStudent(IIITDatabase &db, CsvAppendLog &log) {
+    std::string roll;
+    std::cout << "Roll: ";
+    std::getline(std::cin, roll);
+
+    if (db.findRowByRoll(roll) == IIITDatabase::NOT_FOUND) {
+        std::cout << "No student with roll " << roll << ".\n";
+        return;
+    }
+    if (!rewriteCSVRow(log, roll, static_cast<const IIITStudent *>(nullptr))) return;
+    db.removeStudent(roll);
+    std::cout << "Deleted. Remaining: " << db.liveCount() << "\n";
+}
+
+// -------------- PREDICATE QUERY ----------------
+void runQuery(IIITDatabase &db) {
+    std::cout << "Query, e.g. branch=cse and year>=2022 and not course=oopd\n"
+              << "  fields: branch year roll course current completed grade[COURSE]\n"
+              << "> ";
+    std::string text;
+    std::getline(std::cin, text);
+
+    std::vector<std::size_t> rows;
+    std::vector<std::string> plan;
+    try {
+        rows = db.select(text, &plan);
+    } catch (const std::invalid_argument &e) {
+        std::cout << e.what() << "\n";
+        return;
+    }
+
+    std::cout << "Plan:\n";
+    for (const auto &step : plan) std::cout << "  " << step << "\n";
+
+    const auto &all = db.getStudents();
+    for (auto i : rows) db.printStudentDetailed(all[i]);
+    std::cout << rows.size() << " students matched.\n";
+}
+
+// -------------- GRADE ANALYTICS ----------------
+void printGradeStats(const std::string &label, const GradeStats &st) {
+    std::cout << std::left << std::setw(8) << label << std::right
+              << std::setw(8) << st.count << std::fixed << std::setprecision(3)
+              << std::setw(9) << st.mean << std::setw(9) << st.stddev()
+              << std::setw(8) << (st.count ? st.min : 0.0)
+              << std::setw(8) << (st.count ? st.max : 0.0) << "  ";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    for (std::size_t b = 0; b < GRADE_HIST_BINS; ++b)
+        std::cout << (b ? " " : "") << st.histogram[b];
+    std::cout << "\n";
+}
+
+void showGradeStatistics(IIITDatabase &db) {
+    std::cout << "\nGrade statistics (" << gradeStatsKernelName() << " kernel)\n";
+    std::cout << "Course     Count     Mean   StdDev     Min     Max  "
+                 "Histogram [0,1) .. [9,10]\n";
+    for (const auto &cs : db.courseStatistics()) printGradeStats(cs.first, cs.second);
+    printGradeStats("ALL", db.gradeStatistics());
+}
+
+void showCgpa(const IIITDatabase &db) {
+    std::string roll;
+    std::cout << "Roll: ";
+    std::getline(std::cin, roll);
+
+    std::size_t row = db.findRowByRoll(roll);
+    if (row == IIITDatabase::NOT_FOUND) {
+        std::cout << "No student with roll " << roll << ".\n";
+        return;
+    }
+    db.printStudentDetailed(db.getStudents()[row]);
+    std::cout << "CGPA: " << db.cgpa(row) << "\n";
+}
+
+// -------------- GROUP-BY REPORT ----------------
+void showGroupBy(IIITDatabase &db) {
+    GroupBySpec spec;
+    std::cout << "Group by (any of: branch year course): ";
+    std::string line, word;
+    std::getline(std::cin, line);
+    std::istringstream keys(line);
+    while (keys >> word) {
+        if (word == "branch") spec.byBranch = true;
+        else if (word == "year") spec.byYear = true;
+        else if (word == "course") spec.byCourse = true;
+        else std::cout << "Ignoring unknown key '" << word << "'.\n";
+    }
+
+    int src;
+    std::cout << "Rows: 1 = students (CGPA), 2 = current enrollments, 3 = completed grades: ";
+    while (!(std::cin >> src) || src < 1 || src > 3) {
+        std::cin.clear(); std::cin.ignore(10000, '\n');
+        std::cout << "Enter 1, 2 or 3: ";
+    }
+    std::cin.ignore(10000, '\n');
+    spec.source = src == 1 ? GroupSource::Students
+                : src == 2 ? GroupSource::CurrentCourses
+                           : GroupSource::CompletedCourses;
+
+    std::cout << "Filter query (blank = all students): ";
+    std::getline(std::cin, line);
+
+    std::vector<IIITDatabase::GroupRowT> groups;
+    try {
+        groups = line.find_first_not_of(" \t") == std::string::npos
+                     ? db.groupBy(spec)
+                     : db.groupBy(spec, db.select(line));
+    } catch (const std::invalid_argument &e) {
+        std::cout << e.what() << "\n";
+        return;
+    }
+
+    const bool values = spec.source != GroupSource::CurrentCourses;
+    std::cout << std::left;
+    if (spec.byBranch) std::cout << std::setw(8) << "Branch";
+    if (spec.byYear) std::cout << std::setw(6) << "Year";
+    if (spec.byCourse) std::cout << std::setw(10) << "Course";
+    std::cout << std::right << std::setw(8) << "Count";
+    if (values) std::cout << std::setw(9) << "Avg" << std::setw(8) << "Min" << std::setw(8) << "Max";
+    std::cout << "\n";
+
+    for (const auto &g : groups) {
+        std::cout << std::left;
+        if (spec.byBranch) std::cout << std::setw(8) << branchName(g.branch);
+        if (spec.byYear) std::cout << std::setw(6) << g.year;
+        if (spec.byCourse) std::cout << std::setw(10) << IIITDatabase::KeyTraits::code(g.course);
+        std::cout << std::right << std::setw(8) << g.count;
+        if (values && g.values)
+            std::cout << std::fixed << std::setprecision(3) << std::setw(9) << g.avg()
+                      << std::setw(8) << g.min << std::setw(8) << g.max;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6) << "\n";
+    }
+    std::cout << groups.size() << " groups.\n";
+}
+
+// -------------- EXTERNAL SORT (bounded memory) ----------------
+void externalSortCSV(IIITDatabase &db, CsvAppendLog &log) {
+    ExternalSortOptions opts;
+    std::size_t mib;
+    std::cout << "Memory cap in MiB: ";
+    while (!(std::cin >> mib) || mib == 0) {
+        std::cin.clear(); std::cin.ignore(10000, '\n');
+        std::cout << "Enter a positive number: ";
+    }
+    std::cin.ignore(10000, '\n');
+    opts.memoryLimit = mib << 20;
+    opts.numThreads = std::max(2u, std::thread::hardware_concurrency());
+
+    log.commit();
+    ExternalRollSorter<IIITDatabase::RollType> sorter(db.getThreadPool(), opts);
+    if (!sorter.sort(CSV_FILE, SORTED_FILE)) {
+        std::cerr << "External sort failed.\n";
+        return;
+    }
+
+    const auto &st = sorter.stats();
+    std::cout << "Wrote " << st.rows << " rows to " << SORTED_FILE << " ("
+              << st.runs << " runs, " << st.passes << " merge passes";
+    if (st.skipped) std::cout << ", " << st.skipped << " malformed lines skipped";
+    std::cout << ")\nRuns: " << st.runMicros << " us, merge: " << st.mergeMicros << " us\n";
+}
+
+// ---------------- EXPORT / PAGED VIEW ----------------
+// Streams records through the buffered writer: pick an order, an
+// encoding and a window (offset/limit), to the screen or to a file.
+void exportRecords(const IIITDatabase &db, bool sorted) {
+    auto readSize = [](const char *prompt) {
+        std::size_t v;
+        std::cout << prompt;
+        while (!(std::cin >> v)) {
+            std::cin.clear(); std::cin.ignore(10000, '\n');
+            std::cout << "Enter integer value: ";
+        }
+        std::cin.ignore(10000, '\n');
+        return v;
+    };
+
+    const std::size_t order = readSize("Order (1 = original, 2 = sorted by roll): ");
+    if (order == 2 && !sorted) {
+        std::cout << "Sort first!\n";
+        return;
+    }
+
+    OutputOptions opts;
+    const std::size_t fmt = readSize("Format (1 = pretty, 2 = TSV, 3 = JSON Lines): ");
+    opts.format = fmt == 2 ? OutputFormat::TSV
+                : fmt == 3 ? OutputFormat::JSONL : OutputFormat::Pretty;
+    opts.offset = readSize("Skip first N records: ");
+    const std::size_t limit = readSize("Max records (0 = all): ");
+    if (limit) opts.limit = limit;
+
+    std::string path;
+    std::cout << "Output file (empty = screen): ";
+    std::getline(std::cin, path);
+
+    int fd = STDOUT_FILENO;
+    if (!path.empty()) {
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Cannot open " << path << " for writing.\n";
+            return;
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    const std::size_t n = order == 2 ? db.showSortedOrder(opts, fd)
+                                     : db.showOriginalOrder(opts, fd);
+    auto t1 = std::chrono::steady_clock::now();
+    if (fd != STDOUT_FILENO) ::close(fd);
+
+    std::cout << "\n" << n << " records written";
+    if (!path.empty()) std::cout << " to " << path;
+    std::cout << " in " << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms.\n";
+}
+
+// ---------------- METRICS ----------------
+void showMetrics() {
+    std::size_t choice;
+    std::cout << "Metrics are " << (Metrics::enabled() ? "on" : "off")
+              << ". 1 = JSON, 2 = Prometheus, 3 = reset, 4 = turn "
+              << (Metrics::enabled() ? "off" : "on") << ": ";
+    if (!(std::cin >> choice)) {
+        std::cin.clear(); std::cin.ignore(10000, '\n');
+        return;
+    }
+    std::cin.ignore(10000, '\n');
+
+    switch (choice) {
+    case 1: std::cout << "\n" << Metrics::toJson(); break;
+    case 2: std::cout << "\n" << Metrics::toPrometheus(); break;
+    case 3: Metrics::reset(); std::cout << "Metrics reset.\n"; break;
+    case 4: Metrics::enable(!Metrics::enabled()); break;
+    default: std::cout << "Invalid choice.\n";
+    }
+}
+
+// ---------------- SERVER MODE ----------------
+// oopdassign4 --serve [socket]: loads once and answers command lines
+// (see command.hpp) over a Unix socket until SIGINT / SIGTERM
+int serve(const std::string &socketPath) {
+    // Blocked before any thread exists, so only the server's signalfd
+    // sees them
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+    auto pool = std::make_shared<ThreadPool>();
+    VersionedDatabase<IIITDatabase> versions(pool);
+    auto loader = [](IIITDatabase &db) {
+        const std::size_t threads = std::max(2u, std::thread::hardware_concurrency());
+        if (db.loadWithSnapshot(CSV_FILE, SNAPSHOT_FILE, threads) == LoadSource::Failed)
+            throw std::runtime_error("cannot load " + CSV_FILE);
+        db.parallelSortByRoll(threads);   // for SORT
+    };
+
+    try {
+        versions.rebuild(loader);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    QueryServer<IIITDatabase> server(versions, *pool, loader, socketPath);
+    std::string error;
+    if (!server.start(true, &error)) {
+        std::cerr << "Cannot serve on " << socketPath << ": " << error << "\n";
+        return 1;
+    }
+    std::cerr << "Serving " << versions.snapshot()->liveCount() << " students on "
+              << socketPath << " (" << pool->size() << " workers)\n";
+
+    server.run();
+    std::cerr << "Stopped: " << server.stats().connections << " connections, "
+              << server.stats().requests << " requests.\n";
+    return 0;
+}
+
+// ---------------- BATCH MODE ----------------
+// oopdassign4 --batch <commands> [--out <file>]: runs a file of command
+// lines in one pass and writes the replies (server format) in order
+int runBatch(const std::string &commandsPath, const std::string &outPath) {
+    std::ifstream in(commandsPath);
+    if (!in) {
+        std::cerr << "Cannot open " << commandsPath << "\n";
+        return 1;
+    }
+
+    int fd = STDOUT_FILENO;
+    if (!outPath.empty()) {
+        fd = ::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Cannot open " << outPath << " for writing.\n";
+            return 1;
+        }
+    }
+
+    const std::size_t threads = std::max(2u, std::thread::hardware_concurrency());
+    IIITDatabase db;
+    if (db.loadWithSnapshot(CSV_FILE, SNAPSHOT_FILE, threads) == LoadSource::Failed) {
+        if (fd != STDOUT_FILENO) ::close(fd);
+        return 1;
+    }
+
+    BatchRunner<IIITDatabase> batch(db, threads);
+    const bool ok = batch.run(in, fd);
+    if (fd != STDOUT_FILENO) ::close(fd);
+
+    const BatchStats &st = batch.stats();
+    std::cerr << st.commands << " commands (" << st.evaluated << " evaluated, "
+              << st.errors << " errors) over " << db.liveCount() << " students; plan "
+              << st.planSeconds * 1000.0 << " ms" << (st.sorted ? " (sorted)" : "")
+              << ", run " << st.runSeconds * 1000.0 << " ms\n";
+    if (!ok) std::cerr << "Writing the results failed.\n";
+    return ok ? 0 : 1;
+}
+
+// ---------------- MENU ----------------
+void showMenu() {
+    std::cout << "\n========== MENU ==========\n";
+    std::cout << "1. Load CSV\n";
+    std::cout << "2. Add students manually\n";
+    std::cout << "3. Show original records\n";
+    std::cout << "4. Sort by roll using threads\n";
+    std::cout << "5. Show sorted records\n";
+    std::cout << "6. Query grade >= 9\n";
+    std::cout << "7. Clear CSV\n";
+    std::cout << "8. Show OOPD students (IIIT-Delhi)\n";
+    std::cout << "9. Load CSV (fast, memory-mapped)\n";
+    std::cout << "10. Load CSV (parallel, multi-threaded)\n";
+    std::cout << "11. Load snapshot (rebuilt from CSV when stale)\n";
+    std::cout << "12. Filter by branch (columnar scan)\n";
+    std::cout << "13. Query course grade range\n";
+    std::cout << "14. Top-K students in a course\n";
+    std::cout << "15. Find student by roll\n";
+    std::cout << "16. Edit student\n";
+    std::cout << "17. Delete student\n";
+    std::cout << "18. Filter by courses (all / any)\n";
+    std::cout << "19. Run query\n";
+    std::cout << "20. Grade statistics per course\n";
+    std::cout << "21. CGPA by roll\n";
+    std::cout << "22. Group-by report\n";
+    std::cout << "23. External sort CSV by roll (bounded memory)\n";
+    std::cout << "24. Export / page records (pretty, TSV, JSON Lines)\n";
+    std::cout << "25. Metrics (JSON / Prometheus)\n";
+    std::cout << "0. Exit\n";
+    std::cout << "==========================\n";
+    std::cout << "Enter option: ";
+}
+
+// ---------------- MAIN ----------------
+int main(int argc, char **argv) {
+    // Metrics stay off (a record is one relaxed load) unless --metrics is
+    // given in any mode, or turned on from option 25
+    std::vector<std::string> args(argv + 1, argv + argc);
+    auto metricsFlag = std::find(args.begin(), args.end(), "--metrics");
+    if (metricsFlag != args.end()) {
+        Metrics::enable(true);
+        args.erase(metricsFlag);
+    }
+
+    if (!args.empty() && args[0] == "--serve" && args.size() <= 2)
+        return serve(args.size() == 2 ? args[1] : SOCKET_FILE);
+    if (args.size() == 2 && args[0] == "--batch")
+        return runBatch(args[1], "");
+    if (args.size() == 4 && args[0] == "--batch" && args[2] == "--out")
+        return runBatch(args[1], args[3]);
+    if (!args.empty()) {
+        std::cerr << "usage: " << argv[0] << " [--metrics]"
+                  << " [--serve [socket] | --batch <commands> [--out <file>]]\n";
+        return 2;
+    }
+
+    IIITDatabase db;
+
+    // Open for the whole session; a last row left without its newline
+    // (possibly torn by a crash) is completed, never cut
+    CsvAppendLog log(CSV_FILE);
+    if (!log.isOpen())
+        std::cerr << "Cannot open " << CSV_FILE << " for writing.\n";
+    else if (log.stats().completedLastLine)
+        std::cout << "Note: the last row of " << CSV_FILE << " had no newline; one was added."
+                     " If a crash cut that row short, loading will skip it.\n";
+    bool running = true;
+    bool sorted = false;
+
+    while (running) {
+        showMenu();
+
+        int choice;
+        if (!(std::cin >> choice)) {
+            std::cin.clear(); std::cin.ignore(10000, '\n');
+            continue;
+        }
+        std::cin.ignore(10000, '\n');
+
+        switch (choice) {
+
+        case 1:
+            db.loadFromCSV(CSV_FILE);
+            std::cout << "Loaded. Total: " << db.getStudents().size() << "\n";
+            std::cout << "Load stats: " << db.getLastLoadStats() << "\n";
+            break;
+
+        case 2:
+            addStudentsManually(db, log);
+            break;
+
+        case 3:
+            db.showOriginalOrder();
+            break;
+
+        case 4: {
+            std::size_t t;
+            std::cout << "Threads (>=2 required): ";
+            while (!(std::cin >> t)) {
+                std::cin.clear(); std::cin.ignore(10000, '\n');
+                std::cout << "Enter integer value: ";
+            }
+            std::cin.ignore(10000, '\n');
+
+            if (t < 2) {
+                std::cout << "Using 2 threads (minimum).\n";
+                t = 2;
+            }
+
+            db.parallelSortByRoll(t);
+            printSortTimings(db);
+            sorted = true;
+            break;
+        }
+
+        case 5:
+            if (!sorted) std::cout << "Sort first!\n";
+            else db.showSortedOrder();
+            break;
+
+        case 6: {
+            std::string course;
+            std::cout << "Course to search (>=9): ";
+            std::getline(std::cin, course);
+
+            auto result = db.queryByCourseAndMinGrade(course, 9.0);
+
+            if (result.empty()) std::cout << "None found.\n";
+            else {
+                std::cout << "Students with grade >=9:\n";
+                for (auto s : result) std::cout << *s << "\n";
+            }
+            break;
+        }
+
+        case 7:
+            clearCSV(log, db);
+            sorted = false;
+            break;
+
+        case 8:
+            showOOPDStudents(db);
+            break;
+
+        case 9:
+            db.loadFromCSVMapped(CSV_FILE);
+            sorted = false;
+            std::cout << "Loaded. Total: " << db.getStudents().size() << "\n";
+            std::cout << "Load stats: " << db.getLastLoadStats() << "\n";
+            break;
+
+        case 10: {
+            std::size_t t;
+            std::cout << "Threads: ";
+            while (!(std::cin >> t) || t == 0) {
+                std::cin.clear(); std::cin.ignore(10000, '\n');
+                std::cout << "Enter positive integer value: ";
+            }
+            std::cin.ignore(10000, '\n');
+
+            db.loadFromCSVParallel(CSV_FILE, t);
+            sorted = false;
+            std::cout << "Loaded. Total: " << db.getStudents().size() << "\n";
+            std::cout << "Load stats: " << db.getLastLoadStats() << "\n";
+            break;
+        }
+
+        case 11: {
+            LoadSource src = db.loadWithSnapshot(
+                CSV_FILE, SNAPSHOT_FILE,
+                std::max(2u, std::thread::hardware_concurrency()));
+            sorted = false;
+            if (src == LoadSource::Failed) break;
+
+            std::cout << "Loaded from "
+                      << (src == LoadSource::Snapshot ? "snapshot" : "CSV (snapshot rebuilt)")
+                      << ". Total: " << db.getStudents().size() << "\n";
+            std::cout << "Load stats: " << db.getLastLoadStats() << "\n";
+            break;
+        }
+
+        case 12: {
+            std::string branch;
+            std::cout << "Branch: ";
+            std::getline(std::cin, branch);
+
+            const auto &cols = db.getColumns();
+            auto rows = cols.selectByBranch(branch);
+            if (rows.empty()) {
+                std::cout << "None found.\n";
+                break;
+            }
+            for (auto r : rows) db.printStudentDetailed(cols[r]);
+            std::cout << rows.size() << " students in " << branch << "\n";
+            break;
+        }
+
+        case 13: {
+            std::string course;
+            double lo, hi;
+            std::cout << "Course: ";
+            std::getline(std::cin, course);
+            std::cout << "Min and max grade: ";
+            while (!(std::cin >> lo >> hi)) {
+                std::cin.clear(); std::cin.ignore(10000, '\n');
+                std::cout << "Enter two numbers: ";
+            }
+            std::cin.ignore(10000, '\n');
+
+            auto range = db.queryByCourseGradeRange(course, lo, hi);
+            if (range.empty()) std::cout << "None found.\n";
+            for (auto e : range)
+                std::cout << e.grade << "  " << db.getStudents()[e.row] << "\n";
+            break;
+        }
+
+        case 14: {
+            std::string course;
+            std::size_t k;
+            std::cout << "Course: ";
+            std::getline(std::cin, course);
+            std::cout << "K: ";
+            while (!(std::cin >> k)) {
+                std::cin.clear(); std::cin.ignore(10000, '\n');
+                std::cout << "Enter integer value: ";
+            }
+            std::cin.ignore(10000, '\n');
+
+            auto range = db.topKByCourse(course, k);
+            if (range.empty()) std::cout << "None found.\n";
+            for (auto e : range)
+                std::cout << e.grade << "  " << db.getStudents()[e.row] << "\n";
+            break;
+        }
+
+        case 15:
+            findStudentByRoll(db);
+            break;
+
+        case 16:
+            editStudent(db, log);
+            break;
+
+        case 17:
+            deleteStudent(db, log);
+            break;
+
+        case 18:
+            filterByCourses(db);
+            break;
+
+        case 19:
+            runQuery(db);
+            break;
+
+        case 20:
+            showGradeStatistics(db);
+            break;
+
+        case 21:
+            showCgpa(db);
+            break;
+
+        case 22:
+            showGroupBy(db);
+            break;
+
+        case 23:
+            externalSortCSV(db, log);
+            break;
+
+        case 24:
+            exportRecords(db, sorted);
+            break;
+
+        case 25:
+            showMetrics();
+            break;
+
+        case 0:
+            running = false;
+            break;
+
+        default:
+            std::cout << "Invalid choice.\n";
+        }
+    }
+
+    std::cout << "Exiting...\n";
+    return 0;
+}
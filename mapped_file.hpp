@@ -0,0 +1,97 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ========================
+// Read-only memory-mapped file (RAII)
+// The whole file is mapped once; callers parse it through string_views
+// without copying it into user-space buffers.
+// ========================
+
+class MappedFile {
+private:
+    const char *ptr = nullptr;
+    std::size_t len = 0;
+    bool opened = false;
+
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string &path) { open(path); }
+
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&other) noexcept
+        : ptr(std::exchange(other.ptr, nullptr)),
+          len(std::exchange(other.len, 0)),
+          opened(std::exchange(other.opened, false)) {}
+
+    MappedFile &operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            close();
+            ptr    = std::exchange(other.ptr, nullptr);
+            len    = std::exchange(other.len, 0);
+            opened = std::exchange(other.opened, false);
+        }
+        return *this;
+    }
+
+    bool open(const std::string &path) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        len = static_cast<std::size_t>(st.st_size);
+        if (len > 0) {
+            void *p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                len = 0;
+                return false;
+            }
+            ::madvise(p, len, MADV_SEQUENTIAL);
+            ptr = static_cast<const char *>(p);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+        opened = true;
+        return true;
+    }
+
+    void close() {
+        if (ptr) ::munmap(const_cast<char *>(ptr), len);
+        ptr = nullptr;
+        len = 0;
+        opened = false;
+    }
+
+    bool isOpen() const { return opened; }
+    const char *data() const { return ptr; }
+    std::size_t size() const { return len; }
+
+    std::string_view view() const {
+        return ptr ? std::string_view(ptr, len) : std::string_view();
+    }
+};
+
+#endif // MAPPED_FILE_HPP
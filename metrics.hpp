@@ -0,0 +1,295 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Hot-path instrumentation: counters and latency histograms
+// Every thread records into its own shard (plain relaxed stores, no
+// shared cache lines, no locks); an export sums the shards. When
+// metrics are disabled (the default) a record is one relaxed load and a
+// branch, and ScopedTimer does not even read the clock.
+//
+// Latencies go into log2 buckets: bucket b counts operations that took
+// at most 2^b microseconds, the last one everything slower. Quantiles
+// are reported as bucket upper bounds.
+//
+// The registry is process-wide, like the thread pool's stats: all
+// databases in the process feed the same series.
+// ========================
+
+enum class Counter : std::size_t {
+    RowsParsed, RowsRejected, IndexEntries, QueryHits,
+    Count
+};
+
+enum class Timer : std::size_t {
+    Load, Sort, IndexBuild,
+    GradeQuery, GradeRangeQuery, TopKQuery, CourseFilter, RollLookup, Query, GroupBy,
+    Count
+};
+
+struct Metrics {
+    static constexpr std::size_t COUNTERS = static_cast<std::size_t>(Counter::Count);
+    static constexpr std::size_t TIMERS   = static_cast<std::size_t>(Timer::Count);
+    static constexpr std::size_t BUCKETS  = 32;   // up to 2^31 us (~36 min), then +Inf
+
+    struct TimerStats {
+        std::uint64_t count = 0;
+        std::uint64_t sumNs = 0;
+        std::array<std::uint64_t, BUCKETS + 1> buckets{};
+
+        // Upper bound (ns) of the bucket holding quantile q; 0 if empty
+        std::uint64_t quantileNs(double q) const {
+            if (count == 0) return 0;
+            const std::uint64_t rank = static_cast<std::uint64_t>(q * (count - 1)) + 1;
+            std::uint64_t seen = 0;
+            for (std::size_t b = 0; b < BUCKETS; ++b) {
+                seen += buckets[b];
+                if (seen >= rank) return bucketBoundNs(b);
+            }
+            return bucketBoundNs(BUCKETS - 1) * 2;
+        }
+    };
+
+    struct Snapshot {
+        std::array<std::uint64_t, COUNTERS> counters{};
+        std::array<TimerStats, TIMERS>      timers{};
+    };
+
+    static std::uint64_t bucketBoundNs(std::size_t b) { return 1000ULL << b; }
+
+    static const char *name(Counter c) {
+        static const char *names[COUNTERS] = {
+            "rows_parsed", "rows_rejected", "index_entries", "query_hits"};
+        return names[static_cast<std::size_t>(c)];
+    }
+
+    static const char *name(Timer t) {
+        static const char *names[TIMERS] = {
+            "load", "sort", "index_build", "grade_query", "grade_range_query",
+            "topk_query", "course_filter", "roll_lookup", "query", "group_by"};
+        return names[static_cast<std::size_t>(t)];
+    }
+
+    // ---- Switch ----
+    static std::atomic<bool> &enabledFlag() {
+        static std::atomic<bool> on{false};
+        return on;
+    }
+    static void enable(bool on) { enabledFlag().store(on, std::memory_order_relaxed); }
+    static bool enabled() { return enabledFlag().load(std::memory_order_relaxed); }
+
+    // ---- Recording (calling thread's shard) ----
+    static void add(Counter c, std::uint64_t n = 1) {
+        if (!enabled()) return;
+        bump(local().counters[static_cast<std::size_t>(c)], n);
+    }
+
+    static void observe(Timer t, std::uint64_t ns) {
+        if (!enabled()) return;
+        Shard &s = local();
+        const std::size_t i = static_cast<std::size_t>(t);
+        bump(s.buckets[i][bucketOf(ns)], 1);
+        bump(s.sumNs[i], ns);
+    }
+
+    // ---- Reading ----
+    // Sums every shard. Concurrent recording may or may not be included.
+    static Snapshot snapshot() {
+        Snapshot out;
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const auto &s : r.shards) {
+            for (std::size_t c = 0; c < COUNTERS; ++c)
+                out.counters[c] += s->counters[c].load(std::memory_order_relaxed);
+            for (std::size_t t = 0; t < TIMERS; ++t) {
+                TimerStats &ts = out.timers[t];
+                ts.sumNs += s->sumNs[t].load(std::memory_order_relaxed);
+                for (std::size_t b = 0; b <= BUCKETS; ++b) {
+                    const std::uint64_t v = s->buckets[t][b].load(std::memory_order_relaxed);
+                    ts.buckets[b] += v;
+                    ts.count += v;
+                }
+            }
+        }
+        return out;
+    }
+
+    // Zeroes every series (recording that races with it may survive)
+    static void reset() {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (auto &s : r.shards) s->clear();
+    }
+
+    static std::string toJson() {
+        const Snapshot snap = snapshot();
+        std::string out = "{\n  \"enabled\": ";
+        out += enabled() ? "true" : "false";
+        out += ",\n  \"counters\": {";
+        for (std::size_t c = 0; c < COUNTERS; ++c) {
+            out += c ? ", \"" : "\"";
+            out += name(static_cast<Counter>(c));
+            out += "\": " + std::to_string(snap.counters[c]);
+        }
+        out += "},\n  \"timers\": {\n";
+        for (std::size_t t = 0; t < TIMERS; ++t) {
+            const TimerStats &ts = snap.timers[t];
+            out += "    \"";
+            out += name(static_cast<Timer>(t));
+            out += "\": {\"count\": " + std::to_string(ts.count) +
+                   ", \"sum_ns\": " + std::to_string(ts.sumNs) +
+                   ", \"p50_ns\": " + std::to_string(ts.quantileNs(0.50)) +
+                   ", \"p99_ns\": " + std::to_string(ts.quantileNs(0.99)) +
+                   ", \"buckets_us\": {";
+            bool first = true;
+            for (std::size_t b = 0; b <= BUCKETS; ++b) {
+                if (!ts.buckets[b]) continue;
+                out += first ? "\"" : ", \"";
+                out += b < BUCKETS ? std::to_string(bucketBoundNs(b) / 1000) : "inf";
+                out += "\": " + std::to_string(ts.buckets[b]);
+                first = false;
+            }
+            out += "}}";
+            out += t + 1 < TIMERS ? ",\n" : "\n";
+        }
+        out += "  }\n}\n";
+        return out;
+    }
+
+    // Prometheus text exposition format (version 0.0.4)
+    static std::string toPrometheus() {
+        const Snapshot snap = snapshot();
+        std::string out;
+        for (std::size_t c = 0; c < COUNTERS; ++c) {
+            const std::string metric = std::string("oopd_") + name(static_cast<Counter>(c)) + "_total";
+            out += "# TYPE " + metric + " counter\n";
+            out += metric + " " + std::to_string(snap.counters[c]) + "\n";
+        }
+
+        out += "# HELP oopd_operation_duration_seconds Latency of database operations\n";
+        out += "# TYPE oopd_operation_duration_seconds histogram\n";
+        for (std::size_t t = 0; t < TIMERS; ++t) {
+            const TimerStats &ts = snap.timers[t];
+            const std::string op = std::string("op=\"") + name(static_cast<Timer>(t)) + "\"";
+            std::uint64_t cumulative = 0;
+            for (std::size_t b = 0; b < BUCKETS; ++b) {
+                cumulative += ts.buckets[b];
+                out += "oopd_operation_duration_seconds_bucket{" + op + ",le=\"" +
+                       seconds(bucketBoundNs(b)) + "\"} " + std::to_string(cumulative) + "\n";
+            }
+            out += "oopd_operation_duration_seconds_bucket{" + op + ",le=\"+Inf\"} " +
+                   std::to_string(ts.count) + "\n";
+            out += "oopd_operation_duration_seconds_sum{" + op + "} " + seconds(ts.sumNs) + "\n";
+            out += "oopd_operation_duration_seconds_count{" + op + "} " +
+                   std::to_string(ts.count) + "\n";
+        }
+        return out;
+    }
+
+private:
+    struct Shard {
+        std::atomic<std::uint64_t> counters[COUNTERS];
+        std::atomic<std::uint64_t> buckets[TIMERS][BUCKETS + 1];
+        std::atomic<std::uint64_t> sumNs[TIMERS];
+
+        Shard() { clear(); }
+
+        void clear() {
+            for (auto &c : counters) c.store(0, std::memory_order_relaxed);
+            for (auto &row : buckets)
+                for (auto &b : row) b.store(0, std::memory_order_relaxed);
+            for (auto &s : sumNs) s.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    // Shards outlive their threads (their counts stay in the totals) and
+    // are handed to the next new thread
+    struct Registry {
+        std::mutex                          mutex;
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::vector<Shard *>                spare;
+    };
+
+    static Registry &registry() {
+        static Registry *r = new Registry();   // never destroyed: threads may exit late
+        return *r;
+    }
+
+    static Shard &local() {
+        struct Holder {
+            Shard *shard;
+            Holder() {
+                Registry &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                if (!r.spare.empty()) {
+                    shard = r.spare.back();
+                    r.spare.pop_back();
+                } else {
+                    r.shards.push_back(std::make_unique<Shard>());
+                    shard = r.shards.back().get();
+                }
+            }
+            ~Holder() {
+                Registry &r = registry();
+                std::lock_guard<std::mutex> lock(r.mutex);
+                r.spare.push_back(shard);
+            }
+        };
+        thread_local Holder holder;
+        return *holder.shard;
+    }
+
+    // Only the owning thread writes a shard, so no read-modify-write
+    static void bump(std::atomic<std::uint64_t> &v, std::uint64_t n) {
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    static std::size_t bucketOf(std::uint64_t ns) {
+        const std::uint64_t us = (ns + 999) / 1000;
+        if (us <= 1) return 0;
+        const std::size_t b = 64 - static_cast<std::size_t>(__builtin_clzll(us - 1));
+        return b < BUCKETS ? b : BUCKETS;
+    }
+
+    static std::string seconds(std::uint64_t ns) {
+        std::string s = std::to_string(ns / 1000000000ULL) + ".";
+        std::string frac = std::to_string(ns % 1000000000ULL);
+        s.append(9 - frac.size(), '0');
+        return s + frac;
+    }
+};
+
+// Records the lifetime of the scope into a latency histogram
+class ScopedTimer {
+private:
+    Timer timer;
+    bool  active;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Timer t) : timer(t), active(Metrics::enabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedTimer() {
+        if (!active) return;
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        Metrics::observe(timer, static_cast<std::uint64_t>(ns));
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+};
+
+#endif // METRICS_HPP
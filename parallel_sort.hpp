@@ -0,0 +1,205 @@
+#ifndef PARALLEL_SORT_HPP
+#define PARALLEL_SORT_HPP
+
+#include "thread_pool.hpp"
+
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Parallel block sort + tree merge
+//
+//   1. The input is cut into numThreads blocks, each sorted by its own
+//      pool task (comparison sort, or LSD radix sort for integral keys).
+//   2. Sorted blocks are merged pairwise, level by level, like a
+//      tournament tree. Each merge is further split with merge-path
+//      partitioning, so every level keeps all workers busy, including
+//      the final level, which has only one merge.
+// ========================
+
+struct SortTimings {
+    std::vector<std::pair<std::size_t, std::size_t>> blocks;   // [start, end)
+    std::vector<long long> blockMicros;        // per block-sort task
+    std::vector<long long> mergeLevelMicros;   // per tree level
+    std::vector<std::size_t> mergesPerLevel;
+    long long blockPhaseMicros = 0;
+    long long mergePhaseMicros = 0;
+    bool radix = false;
+};
+
+// Merge-path co-rank: number of elements taken from `a` among the first
+// `d` outputs of a stable merge of a[0..m) and b[0..n) (ties go to `a`).
+template <typename It, typename Comp>
+std::size_t mergePathCoRank(It a, std::size_t m, It b, std::size_t n,
+                            std::size_t d, Comp comp) {
+    std::size_t lo = d > n ? d - n : 0;
+    std::size_t hi = std::min(d, m);
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        std::size_t j = d - i;
+        if (i < m && j > 0 && !comp(b[j - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+// Stable LSD radix sort of [first, last) by an unsigned integral key.
+// Byte passes where every element shares the same digit are skipped,
+// so narrow roll ranges cost only one or two passes.
+template <typename T, typename KeyFn>
+void radixSortByKey(T *first, T *last, KeyFn key) {
+    using UKey = std::decay_t<decltype(key(*first))>;
+    static_assert(std::is_unsigned<UKey>::value, "radix key must be unsigned");
+
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2) return;
+
+    std::vector<UKey> keys(n), keysTmp(n);
+    std::vector<T>    tmp(n);
+    for (std::size_t i = 0; i < n; ++i) keys[i] = key(first[i]);
+
+    T    *src = first,       *dst = tmp.data();
+    UKey *ks  = keys.data(), *kd  = keysTmp.data();
+
+    for (std::size_t shift = 0; shift < sizeof(UKey) * 8; shift += 8) {
+        std::size_t count[256] = {};
+        for (std::size_t i = 0; i < n; ++i) ++count[(ks[i] >> shift) & 0xFF];
+
+        if (count[(ks[0] >> shift) & 0xFF] == n) continue;   // digit is constant
+
+        std::size_t pos = 0;
+        for (auto &c : count) {
+            std::size_t c0 = c;
+            c = pos;
+            pos += c0;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t slot = count[(ks[i] >> shift) & 0xFF]++;
+            dst[slot] = std::move(src[i]);
+            kd[slot]  = ks[i];
+        }
+        std::swap(src, dst);
+        std::swap(ks, kd);
+    }
+
+    if (src != first) std::move(src, src + n, first);
+}
+
+// Maps an integral key to an unsigned key with the same ordering
+template <typename K>
+auto radixKey(K k) {
+    using U = std::make_unsigned_t<K>;
+    U u = static_cast<U>(k);
+    if constexpr (std::is_signed<K>::value) u ^= U(1) << (sizeof(U) * 8 - 1);
+    return u;
+}
+
+// Sorts `data` with numThreads block-sort tasks followed by a parallel
+// tree merge, all run on `pool`. `blockSort(first, last)` sorts one block
+// in place and must order elements consistently with `comp`.
+template <typename T, typename Comp, typename BlockSort>
+void parallelBlockSortMerge(ThreadPool &pool, std::vector<T> &data,
+                            std::size_t numThreads, Comp comp,
+                            BlockSort blockSort, SortTimings &timings) {
+    using clock = std::chrono::high_resolution_clock;
+    auto micros = [](clock::time_point a, clock::time_point b) {
+        return static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(b - a).count());
+    };
+
+    const std::size_t n = data.size();
+    if (numThreads == 0) numThreads = 1;
+    if (numThreads > n) numThreads = std::max<std::size_t>(n, 1);
+
+    // ---- Phase 1: block sort ----
+    timings.blocks.clear();
+    std::size_t baseSize = n / numThreads;
+    std::size_t remainder = n % numThreads;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < numThreads; ++i) {
+        std::size_t end = start + baseSize + (i < remainder ? 1 : 0);
+        timings.blocks.emplace_back(start, end);
+        start = end;
+    }
+
+    timings.blockMicros.assign(numThreads, 0);
+    auto phaseStart = clock::now();
+
+    pool.parallelFor(numThreads, [&](std::size_t i) {
+        auto tStart = clock::now();
+        blockSort(data.data() + timings.blocks[i].first,
+                  data.data() + timings.blocks[i].second);
+        timings.blockMicros[i] = micros(tStart, clock::now());
+    });
+
+    auto phaseEnd = clock::now();
+    timings.blockPhaseMicros = micros(phaseStart, phaseEnd);
+
+    // ---- Phase 2: pairwise tree merge (ping-pong between two buffers) ----
+    timings.mergeLevelMicros.clear();
+    timings.mergesPerLevel.clear();
+
+    std::vector<std::pair<std::size_t, std::size_t>> runs = timings.blocks;
+    std::vector<T> buffer(runs.size() > 1 ? n : 0);
+    T *src = data.data();
+    T *dst = buffer.data();
+
+    while (runs.size() > 1) {
+        auto levelStart = clock::now();
+
+        const std::size_t merges = runs.size() / 2;
+        const std::size_t parts  = std::max<std::size_t>(1, numThreads / merges);
+
+        // One task per (merge, partition); an odd trailing run is copied
+        struct Task { std::size_t run, part; };
+        std::vector<Task> tasks;
+        for (std::size_t m = 0; m < merges; ++m)
+            for (std::size_t p = 0; p < parts; ++p) tasks.push_back({2 * m, p});
+
+        pool.parallelFor(tasks.size(), [&](std::size_t t) {
+            const auto &a = runs[tasks[t].run];
+            const auto &b = runs[tasks[t].run + 1];
+            const std::size_t m = a.second - a.first;
+            const std::size_t len = b.second - a.first;
+
+            std::size_t d0 = len * tasks[t].part / parts;
+            std::size_t d1 = len * (tasks[t].part + 1) / parts;
+            std::size_t i0 = mergePathCoRank(src + a.first, m, src + b.first,
+                                             len - m, d0, comp);
+            std::size_t i1 = mergePathCoRank(src + a.first, m, src + b.first,
+                                             len - m, d1, comp);
+
+            std::merge(src + a.first + i0, src + a.first + i1,
+                       src + b.first + (d0 - i0), src + b.first + (d1 - i1),
+                       dst + a.first + d0, comp);
+        });
+
+        std::vector<std::pair<std::size_t, std::size_t>> next;
+        for (std::size_t m = 0; m < merges; ++m)
+            next.emplace_back(runs[2 * m].first, runs[2 * m + 1].second);
+        if (runs.size() % 2) {
+            const auto &last = runs.back();
+            std::copy(src + last.first, src + last.second, dst + last.first);
+            next.push_back(last);
+        }
+
+        runs.swap(next);
+        std::swap(src, dst);
+
+        timings.mergesPerLevel.push_back(merges);
+        timings.mergeLevelMicros.push_back(micros(levelStart, clock::now()));
+    }
+
+    if (src != data.data()) std::copy(src, src + n, data.data());
+    timings.mergePhaseMicros = micros(phaseEnd, clock::now());
+}
+
+#endif // PARALLEL_SORT_HPP
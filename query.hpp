@@ -0,0 +1,744 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include "symbol_table.hpp"
+#include "enrollment_index.hpp"
+#include "csv_parse.hpp"
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <cmath>
+#include <cctype>
+#include <stdexcept>
+#include <type_traits>
+#include <sstream>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Student predicates
+// A Query is an immutable predicate tree: leaves test one attribute
+// (branch, start year, roll, course enrollment, course grade) and inner
+// nodes combine them with AND / OR / NOT. Nodes are shared, so copying
+// and combining queries is cheap.
+//
+//   auto q = Query::branch("cse") && Query::startYear(2022, 2024) &&
+//            !Query::course("oopd");
+// ========================
+
+template <typename RollT, typename CourseCodeT>
+class Query {
+public:
+    enum class Kind { All, Branch, StartYear, Roll, Course, Grade, And, Or, Not };
+
+    struct Node {
+        Kind        kind = Kind::All;
+        std::string branchName;
+        BranchId    branch = SymbolTable<BranchId>::NONE;
+        int         yearLo = 0, yearHi = 0;
+        RollT       rollLo{}, rollHi{};
+        CourseCodeT course{};
+        CourseRole  role = CourseRole::Any;
+        double      gradeLo = 0.0, gradeHi = 0.0;
+        std::vector<Query> children;
+    };
+
+private:
+    std::shared_ptr<const Node> node;
+
+    explicit Query(Node n) : node(std::make_shared<const Node>(std::move(n))) {}
+
+    // a && (b && c) is stored as one AND with three children
+    static Query combine(Kind kind, const Query &a, const Query &b) {
+        Node n;
+        n.kind = kind;
+        for (const Query *q : {&a, &b}) {
+            if (q->kind() == kind)
+                n.children.insert(n.children.end(), q->get().children.begin(),
+                                  q->get().children.end());
+            else
+                n.children.push_back(*q);
+        }
+        return Query(std::move(n));
+    }
+
+public:
+    // Matches every live student
+    Query() : Query(Node()) {}
+
+    const Node &get() const { return *node; }
+    Kind kind() const { return node->kind; }
+
+    static Query all() { return Query(); }
+
+    // Exact branch name, as stored
+    static Query branch(const std::string &b) {
+        Node n;
+        n.kind = Kind::Branch;
+        n.branchName = b;
+        n.branch = branchSymbols().find(b);
+        return Query(std::move(n));
+    }
+
+    static Query startYear(int lo, int hi) {
+        Node n;
+        n.kind = Kind::StartYear;
+        n.yearLo = lo;
+        n.yearHi = hi;
+        return Query(std::move(n));
+    }
+
+    // Rolls in [lo, hi], compared with RollT's operator<
+    static Query rollRange(const RollT &lo, const RollT &hi) {
+        Node n;
+        n.kind = Kind::Roll;
+        n.rollLo = lo;
+        n.rollHi = hi;
+        return Query(std::move(n));
+    }
+
+    static Query roll(const RollT &r) { return rollRange(r, r); }
+
+    // Enrolled in (or completed) `c`, any letter case
+    static Query course(const CourseCodeT &c, CourseRole role = CourseRole::Any) {
+        Node n;
+        n.kind = Kind::Course;
+        n.course = c;
+        n.role = role;
+        return Query(std::move(n));
+    }
+
+    // Completed `c` with a grade in [lo, hi]
+    static Query grade(const CourseCodeT &c, double lo,
+                       double hi = std::numeric_limits<double>::infinity()) {
+        Node n;
+        n.kind = Kind::Grade;
+        n.course = c;
+        n.gradeLo = lo;
+        n.gradeHi = hi;
+        return Query(std::move(n));
+    }
+
+    friend Query operator&&(const Query &a, const Query &b) {
+        return combine(Kind::And, a, b);
+    }
+
+    friend Query operator||(const Query &a, const Query &b) {
+        return combine(Kind::Or, a, b);
+    }
+
+    friend Query operator!(const Query &a) {
+        Node n;
+        n.kind = Kind::Not;
+        n.children.push_back(a);
+        return Query(std::move(n));
+    }
+
+    // Text form, in the syntax parseQuery() accepts
+    std::string describe() const {
+        std::ostringstream os;
+        const Node &n = *node;
+        switch (n.kind) {
+        case Kind::All:       os << "all"; break;
+        case Kind::Branch:    os << "branch=" << n.branchName; break;
+        case Kind::StartYear:
+            if (n.yearHi == std::numeric_limits<int>::max()) os << "year>=" << n.yearLo;
+            else if (n.yearLo == std::numeric_limits<int>::min()) os << "year<=" << n.yearHi;
+            else if (n.yearLo == n.yearHi) os << "year=" << n.yearLo;
+            else os << "year=" << n.yearLo << ".." << n.yearHi;
+            break;
+        case Kind::Roll:
+            os << "roll=" << n.rollLo;
+            if (n.rollLo < n.rollHi) os << ".." << n.rollHi;
+            break;
+        case Kind::Course:
+            os << (n.role == CourseRole::Current   ? "current="
+                 : n.role == CourseRole::Completed ? "completed="
+                                                   : "course=")
+               << n.course;
+            break;
+        case Kind::Grade:
+            os << "grade[" << n.course << "]";
+            if (std::isinf(n.gradeHi)) os << ">=" << n.gradeLo;
+            else if (std::isinf(n.gradeLo)) os << "<=" << n.gradeHi;
+            else os << "=" << n.gradeLo << ".." << n.gradeHi;
+            break;
+        case Kind::Not:
+            os << "not " << n.children[0].describe();
+            break;
+        case Kind::And:
+        case Kind::Or:
+            os << "(";
+            for (std::size_t i = 0; i < n.children.size(); ++i) {
+                if (i) os << (n.kind == Kind::And ? " and " : " or ");
+                os << n.children[i].describe();
+            }
+            os << ")";
+            break;
+        }
+        return os.str();
+    }
+};
+
+// ========================
+// Query text parser
+//   expr   := term ("or" term)*
+//   term   := factor ("and" factor)*
+//   factor := "not" factor | "(" expr ")" | predicate
+// Predicates (no spaces inside):
+//   branch=cse   year=2022   year>=2022   year<=2023   year=2021..2023
+//   roll=20275   roll=20000..20500
+//   course=oopd  current=oopd  completed=12345
+//   grade[12345]>=9   grade[12345]<=6   grade[12345]=7..9
+// Throws std::invalid_argument on malformed input.
+// ========================
+
+template <typename RollT, typename CourseCodeT>
+class QueryParser {
+public:
+    using QueryT = Query<RollT, CourseCodeT>;
+
+private:
+    std::vector<std::string> tokens;
+    std::size_t pos = 0;
+
+    static bool isWord(const std::string &tok, const char *word) {
+        if (tok.size() != std::char_traits<char>::length(word)) return false;
+        for (std::size_t i = 0; i < tok.size(); ++i)
+            if (std::tolower(static_cast<unsigned char>(tok[i])) != word[i]) return false;
+        return true;
+    }
+
+    [[noreturn]] static void fail(const std::string &msg) {
+        throw std::invalid_argument("query: " + msg);
+    }
+
+    template <typename T>
+    static T value(std::string_view text, const std::string &tok) {
+        T out{};
+        bool ok;
+        if constexpr (std::is_floating_point<T>::value) ok = parseNumber(text, out);
+        else ok = parseKey(text, out);
+        if (text.empty() || !ok) fail("bad value in '" + tok + "'");
+        return out;
+    }
+
+    // Splits "a..b" (or just "a", giving a..a)
+    template <typename T>
+    static void bounds(std::string_view text, const std::string &tok, T &lo, T &hi) {
+        auto dots = text.find("..");
+        if (dots == std::string_view::npos) {
+            lo = hi = value<T>(text, tok);
+        } else {
+            lo = value<T>(text.substr(0, dots), tok);
+            hi = value<T>(text.substr(dots + 2), tok);
+        }
+    }
+
+    static QueryT predicate(const std::string &tok) {
+        std::string_view t(tok);
+        std::size_t opPos = t.find_first_of("<>=");
+        if (opPos == std::string_view::npos || opPos == 0) fail("expected a predicate at '" + tok + "'");
+
+        std::string_view field = t.substr(0, opPos);
+        std::string_view op = t.substr(opPos, (t.size() > opPos + 1 && t[opPos + 1] == '=') ? 2 : 1);
+        std::string_view rhs = t.substr(opPos + op.size());
+        if (op != "=" && op != ">=" && op != "<=") fail("unsupported operator in '" + tok + "'");
+
+        if (field == "branch" && op == "=") return QueryT::branch(std::string(rhs));
+
+        if (field == "year") {
+            int lo, hi;
+            if (op == "=") bounds(rhs, tok, lo, hi);
+            else if (op == ">=") { lo = value<int>(rhs, tok); hi = std::numeric_limits<int>::max(); }
+            else { lo = std::numeric_limits<int>::min(); hi = value<int>(rhs, tok); }
+            return QueryT::startYear(lo, hi);
+        }
+
+        if (field == "roll" && op == "=") {
+            RollT lo, hi;
+            bounds(rhs, tok, lo, hi);
+            return QueryT::rollRange(lo, hi);
+        }
+
+        if (op == "=") {
+            if (field == "course")    return QueryT::course(value<CourseCodeT>(rhs, tok), CourseRole::Any);
+            if (field == "current")   return QueryT::course(value<CourseCodeT>(rhs, tok), CourseRole::Current);
+            if (field == "completed") return QueryT::course(value<CourseCodeT>(rhs, tok), CourseRole::Completed);
+        }
+
+        if (field.size() > 7 && field.substr(0, 6) == "grade[" && field.back() == ']') {
+            auto course = value<CourseCodeT>(field.substr(6, field.size() - 7), tok);
+            double lo, hi;
+            if (op == "=") bounds(rhs, tok, lo, hi);
+            else if (op == ">=") { lo = value<double>(rhs, tok); hi = std::numeric_limits<double>::infinity(); }
+            else { lo = -std::numeric_limits<double>::infinity(); hi = value<double>(rhs, tok); }
+            return QueryT::grade(course, lo, hi);
+        }
+
+        fail("unknown predicate '" + tok + "'");
+    }
+
+    bool atEnd() const { return pos >= tokens.size(); }
+
+    QueryT expr() {
+        QueryT q = term();
+        while (!atEnd() && isWord(tokens[pos], "or")) {
+            ++pos;
+            q = q || term();
+        }
+        return q;
+    }
+
+    QueryT term() {
+        QueryT q = factor();
+        while (!atEnd() && isWord(tokens[pos], "and")) {
+            ++pos;
+            q = q && factor();
+        }
+        return q;
+    }
+
+    QueryT factor() {
+        if (atEnd()) fail("unexpected end of query");
+        const std::string &tok = tokens[pos++];
+        if (isWord(tok, "not")) return !factor();
+        if (tok == "(") {
+            QueryT q = expr();
+            if (atEnd() || tokens[pos] != ")") fail("missing ')'");
+            ++pos;
+            return q;
+        }
+        if (isWord(tok, "all")) return QueryT::all();
+        return predicate(tok);
+    }
+
+public:
+    QueryT parse(std::string_view text) {
+        tokens.clear();
+        pos = 0;
+
+        std::string cur;
+        for (char c : text) {
+            if (c == '(' || c == ')' || isSpaceChar(c)) {
+                if (!cur.empty()) tokens.push_back(std::move(cur));
+                cur.clear();
+                if (!isSpaceChar(c)) tokens.emplace_back(1, c);
+            } else {
+                cur += c;
+            }
+        }
+        if (!cur.empty()) tokens.push_back(std::move(cur));
+        if (tokens.empty()) fail("empty query");
+
+        QueryT q = expr();
+        if (!atEnd()) fail("unexpected '" + tokens[pos] + "'");
+        return q;
+    }
+};
+
+template <typename RollT, typename CourseCodeT>
+Query<RollT, CourseCodeT> parseQuery(std::string_view text) {
+    return QueryParser<RollT, CourseCodeT>().parse(text);
+}
+
+// ========================
+// Query engine
+// Evaluates a Query against a StudentDatabase and returns the matching
+// rows of getStudents(), ascending.
+//
+// Every node has two strategies: materialise (produce its row list,
+// from an index or a batched column scan) and probe (test one record).
+// Leaves use an index when there is one: the enrollment bitmaps, the
+// grade index, the roll hash, or the sorted-by-roll view for ranges;
+// otherwise they scan their column in fixed-size batches with a
+// branch-free compare loop the compiler can vectorise, then compact the
+// batch into the selection vector.
+//
+// AND nodes are planned by estimated cost: the cheapest child drives,
+// and each remaining child (most selective first) is either probed on
+// the surviving candidates or materialised and intersected, whichever
+// is estimated cheaper.
+// ========================
+
+template <typename DB>
+class QueryEngine {
+public:
+    using RollT       = typename DB::RollType;
+    using CourseCodeT = typename DB::CourseCodeType;
+    using QueryT      = Query<RollT, CourseCodeT>;
+    using Node        = typename QueryT::Node;
+    using Kind        = typename QueryT::Kind;
+    using KeyTraits   = CourseKeyTraits<CourseCodeT>;
+    using Rows        = std::vector<std::size_t>;
+
+private:
+    // Relative per-row costs
+    static constexpr double SCAN_ROW  = 0.25;  // batched column compare
+    static constexpr double INDEX_ROW = 1.0;   // row produced by an index
+    static constexpr double PROBE_ROW = 1.0;   // one record test
+    static constexpr std::size_t BATCH = 256;
+
+    struct Estimate {
+        double rows;
+        double cost;
+    };
+
+    const DB &db;
+    const typename DB::ColumnStoreT &cols;
+    const std::vector<typename DB::StudentT> &students;
+    const double live;
+    std::vector<std::string> *trace;
+    int depth = 0;
+
+    void note(const std::string &line) const {
+        if (trace) trace->push_back(std::string(depth * 2, ' ') + line);
+    }
+
+    static double sortCost(double k) { return k * (1.0 + std::log2(k + 1.0)); }
+
+    // ---- Index lookups ----
+    const RowBitmap *courseBitmap(const Node &n, bool completed) const {
+        const auto folded = KeyTraits::findFolded(n.course);
+        if (folded == KeyTraits::NONE) return nullptr;
+        const auto &maps = completed ? db.getEnrollmentIndex().completedBitmaps()
+                                     : db.getEnrollmentIndex().currentBitmaps();
+        return maps.find(folded);
+    }
+
+    bool isPoint(const Node &n) const { return !(n.rollLo < n.rollHi) && !(n.rollHi < n.rollLo); }
+
+    // [first, last) of the roll range within the sorted view
+    std::pair<std::size_t, std::size_t> sortedSpan(const Node &n) const {
+        const auto &sorted = db.getSortedIndices();
+        auto lo = std::lower_bound(sorted.begin(), sorted.end(), n.rollLo,
+                                   [this](std::size_t i, const RollT &r) {
+                                       return students[i].getRoll() < r;
+                                   });
+        auto hi = std::upper_bound(lo, sorted.end(), n.rollHi,
+                                   [this](const RollT &r, std::size_t i) {
+                                       return r < students[i].getRoll();
+                                   });
+        return {static_cast<std::size_t>(lo - sorted.begin()),
+                static_cast<std::size_t>(hi - sorted.begin())};
+    }
+
+    // ---- Estimates ----
+    Estimate estimate(const Node &n) const {
+        switch (n.kind) {
+        case Kind::All:
+            return {live, live * SCAN_ROW};
+
+        case Kind::Branch: {
+            double distinct = std::max<double>(1.0, static_cast<double>(branchSymbols().size()));
+            if (n.branch == SymbolTable<BranchId>::NONE) return {0.0, 1.0};
+            return {live / distinct, live * SCAN_ROW};
+        }
+
+        case Kind::StartYear:
+            return {live / 3.0, live * SCAN_ROW};
+
+        case Kind::Roll:
+            if (isPoint(n)) return {1.0, 1.0};
+            if (!db.getSortedIndices().empty()) {
+                auto span = sortedSpan(n);
+                double k = static_cast<double>(span.second - span.first);
+                return {k, std::log2(live + 1.0) + sortCost(k)};
+            }
+            return {live / 3.0, live * SCAN_ROW * 4.0};   // non-vectorised compare
+
+        case Kind::Course: {
+            double k = 0.0;
+            if (n.role != CourseRole::Completed)
+                if (auto *b = courseBitmap(n, false)) k += static_cast<double>(b->cardinality());
+            if (n.role != CourseRole::Current)
+                if (auto *b = courseBitmap(n, true)) k += static_cast<double>(b->cardinality());
+            return {k, k * INDEX_ROW + 1.0};
+        }
+
+        case Kind::Grade: {
+            double k = static_cast<double>(
+                db.getGradeIndex().between(KeyTraits::find(n.course), n.gradeLo, n.gradeHi).size());
+            return {k, sortCost(k) + 1.0};
+        }
+
+        case Kind::Not: {
+            Estimate c = estimate(n.children[0].get());
+            return {std::max(0.0, live - c.rows), c.cost + live * SCAN_ROW};
+        }
+
+        case Kind::Or: {
+            Estimate e{0.0, 0.0};
+            for (const auto &ch : n.children) {
+                Estimate c = estimate(ch.get());
+                e.rows += c.rows;
+                e.cost += c.cost + c.rows;
+            }
+            e.rows = std::min(e.rows, live);
+            return e;
+        }
+
+        case Kind::And: {
+            // Independence assumption for the row count; the cost follows
+            // the same plan evalAnd() will choose
+            std::vector<Estimate> ests;
+            for (const auto &ch : n.children) ests.push_back(estimate(ch.get()));
+            std::size_t driver = cheapest(ests);
+
+            double rows = ests[driver].rows, cost = ests[driver].cost;
+            for (std::size_t i : byRows(ests, driver)) {
+                const Node &ch = n.children[i].get();
+                cost += std::min(rows * probeCost(ch), ests[i].cost + rows + ests[i].rows);
+                rows *= live > 0.0 ? ests[i].rows / live : 0.0;
+            }
+            return {rows, cost};
+        }
+        }
+        return {live, live};
+    }
+
+    double probeCost(const Node &n) const {
+        switch (n.kind) {
+        case Kind::And:
+        case Kind::Or: {
+            double c = 0.0;
+            for (const auto &ch : n.children) c += probeCost(ch.get());
+            return c;
+        }
+        case Kind::Not:
+            return probeCost(n.children[0].get());
+        case Kind::Course:
+        case Kind::Grade:
+            return 2.0 * PROBE_ROW;
+        default:
+            return PROBE_ROW;
+        }
+    }
+
+    static std::size_t cheapest(const std::vector<Estimate> &ests) {
+        std::size_t best = 0;
+        for (std::size_t i = 1; i < ests.size(); ++i)
+            if (ests[i].cost < ests[best].cost) best = i;
+        return best;
+    }
+
+    // Children other than `skip`, most selective first
+    static std::vector<std::size_t> byRows(const std::vector<Estimate> &ests, std::size_t skip) {
+        std::vector<std::size_t> order;
+        for (std::size_t i = 0; i < ests.size(); ++i)
+            if (i != skip) order.push_back(i);
+        std::stable_sort(order.begin(), order.end(), [&ests](std::size_t a, std::size_t b) {
+            return ests[a].rows < ests[b].rows;
+        });
+        return order;
+    }
+
+    // ---- Probing one record ----
+    bool matches(const Node &n, std::size_t row) const {
+        const auto &s = students[row];
+        switch (n.kind) {
+        case Kind::All:       return true;
+        case Kind::Branch:    return s.getBranchId() == n.branch;
+        case Kind::StartYear: return s.getStartYear() >= n.yearLo && s.getStartYear() <= n.yearHi;
+        case Kind::Roll:      return !(s.getRoll() < n.rollLo) && !(n.rollHi < s.getRoll());
+        case Kind::Course: {
+            const RowBitmap *cur  = n.role != CourseRole::Completed ? courseBitmap(n, false) : nullptr;
+            const RowBitmap *done = n.role != CourseRole::Current ? courseBitmap(n, true) : nullptr;
+            return (cur && cur->contains(row)) || (done && done->contains(row));
+        }
+        case Kind::Grade: {
+            const double *g = s.findGrade(KeyTraits::find(n.course));
+            return g && *g >= n.gradeLo && *g <= n.gradeHi;
+        }
+        case Kind::Not:
+            return !matches(n.children[0].get(), row);
+        case Kind::And:
+            for (const auto &ch : n.children)
+                if (!matches(ch.get(), row)) return false;
+            return true;
+        case Kind::Or:
+            for (const auto &ch : n.children)
+                if (matches(ch.get(), row)) return true;
+            return false;
+        }
+        return false;
+    }
+
+    // ---- Batched column scan ----
+    // keep(value) is evaluated for a whole batch into a byte mask, then
+    // the batch is compacted branch-free into the selection vector.
+    template <typename T, typename Keep>
+    Rows scan(const std::vector<T> &column, Keep keep) const {
+        const auto &source = cols.sourceRows();
+        const std::size_t n = column.size();
+        Rows out(n);
+        std::size_t k = 0;
+        std::uint8_t mask[BATCH];
+
+        for (std::size_t base = 0; base < n; base += BATCH) {
+            const std::size_t m = std::min(BATCH, n - base);
+            const T *v = column.data() + base;
+            for (std::size_t i = 0; i < m; ++i) mask[i] = keep(v[i]) ? 1 : 0;
+            for (std::size_t i = 0; i < m; ++i) {
+                out[k] = source[base + i];
+                k += mask[i];
+            }
+        }
+        out.resize(k);
+        return out;
+    }
+
+    // ---- Materialising a node ----
+    Rows eval(const Node &n) {
+        switch (n.kind) {
+        case Kind::All:
+            note("all: every live row");
+            return cols.sourceRows();
+
+        case Kind::Branch: {
+            note("scan branch column for " + n.branchName);
+            const BranchId id = n.branch;
+            if (id == SymbolTable<BranchId>::NONE) return {};
+            return scan(cols.branches(), [id](BranchId b) { return b == id; });
+        }
+
+        case Kind::StartYear: {
+            note("scan start-year column");
+            const std::int32_t lo = n.yearLo, hi = n.yearHi;
+            return scan(cols.startYears(),
+                        [lo, hi](std::int32_t y) { return (y >= lo) & (y <= hi); });
+        }
+
+        case Kind::Roll:
+            return evalRoll(n);
+
+        case Kind::Course: {
+            note("enrollment bitmap index");
+            RowBitmap rows;
+            if (n.role != CourseRole::Completed)
+                if (auto *b = courseBitmap(n, false)) rows |= *b;
+            if (n.role != CourseRole::Current)
+                if (auto *b = courseBitmap(n, true)) rows |= *b;
+            return rows.toVector();
+        }
+
+        case Kind::Grade: {
+            note("grade index range");
+            auto range = db.getGradeIndex().between(KeyTraits::find(n.course),
+                                                    n.gradeLo, n.gradeHi);
+            Rows rows(range.rowData(), range.rowData() + range.size());
+            std::sort(rows.begin(), rows.end());
+            return rows;
+        }
+
+        case Kind::Not: {
+            note("not: complement of");
+            ++depth;
+            Rows inner = eval(n.children[0].get());
+            --depth;
+            const auto &all = cols.sourceRows();
+            Rows out;
+            std::set_difference(all.begin(), all.end(), inner.begin(), inner.end(),
+                                std::back_inserter(out));
+            return out;
+        }
+
+        case Kind::Or: {
+            note("or: union of " + std::to_string(n.children.size()) + " inputs");
+            ++depth;
+            Rows out;
+            for (const auto &ch : n.children) {
+                Rows part = eval(ch.get());
+                Rows merged;
+                std::set_union(out.begin(), out.end(), part.begin(), part.end(),
+                               std::back_inserter(merged));
+                out.swap(merged);
+            }
+            --depth;
+            return out;
+        }
+
+        case Kind::And:
+            return evalAnd(n);
+        }
+        return {};
+    }
+
+    Rows evalRoll(const Node &n) {
+        if (isPoint(n)) {
+            note("roll hash index lookup");
+            Rows rows;
+            db.forEachRowWithRoll(n.rollLo, [&rows](std::size_t i) { rows.push_back(i); });
+            std::sort(rows.begin(), rows.end());
+            return rows;
+        }
+
+        const auto &sorted = db.getSortedIndices();
+        if (!sorted.empty()) {
+            note("roll range on sorted view");
+            auto span = sortedSpan(n);
+            Rows rows;
+            for (std::size_t p = span.first; p < span.second; ++p)
+                if (!db.isRemoved(sorted[p])) rows.push_back(sorted[p]);
+            std::sort(rows.begin(), rows.end());
+            return rows;
+        }
+
+        note("scan roll column");
+        const RollT lo = n.rollLo, hi = n.rollHi;
+        return scan(cols.rolls(), [&lo, &hi](const RollT &r) { return !(r < lo) && !(hi < r); });
+    }
+
+    Rows evalAnd(const Node &n) {
+        std::vector<Estimate> ests;
+        for (const auto &ch : n.children) ests.push_back(estimate(ch.get()));
+        const std::size_t driver = cheapest(ests);
+
+        note("and: drive with " + n.children[driver].describe() + " (~" +
+             std::to_string(static_cast<long long>(ests[driver].rows)) + " rows)");
+        ++depth;
+        Rows rows = eval(n.children[driver].get());
+
+        for (std::size_t i : byRows(ests, driver)) {
+            if (rows.empty()) break;
+            const Node &ch = n.children[i].get();
+            const double probe = static_cast<double>(rows.size()) * probeCost(ch);
+            const double build = ests[i].cost + static_cast<double>(rows.size()) + ests[i].rows;
+
+            if (probe <= build) {
+                note("probe " + n.children[i].describe() + " on " +
+                     std::to_string(rows.size()) + " candidates");
+                Rows kept;
+                for (auto r : rows)
+                    if (matches(ch, r)) kept.push_back(r);
+                rows.swap(kept);
+            } else {
+                note("intersect with " + n.children[i].describe());
+                ++depth;
+                Rows other = eval(ch);
+                --depth;
+                Rows kept;
+                std::set_intersection(rows.begin(), rows.end(), other.begin(), other.end(),
+                                      std::back_inserter(kept));
+                rows.swap(kept);
+            }
+        }
+        --depth;
+        return rows;
+    }
+
+public:
+    // `plan`, if given, receives one line per step taken
+    QueryEngine(const DB &db, std::vector<std::string> *plan = nullptr)
+        : db(db), cols(db.getColumns()), students(db.getStudents()),
+          live(static_cast<double>(db.liveCount())), trace(plan) {}
+
+    Rows run(const QueryT &q) { return eval(q.get()); }
+};
+
+#endif // QUERY_HPP
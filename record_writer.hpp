@@ -0,0 +1,270 @@
+#ifndef RECORD_WRITER_HPP
+#define RECORD_WRITER_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <type_traits>
+#include <limits>
+#include <iostream>
+#include <cstdio>
+#include <cerrno>
+#include <cstddef>
+
+#include <unistd.h>
+
+// ========================
+// Buffered record output
+// Records are formatted into one reusable buffer (std::to_chars for
+// numbers, no iostreams) and handed to the kernel in large write()
+// calls on a file descriptor, so dumping a big roster to a pipe is not
+// bound by per-field operator<< calls.
+//
+// Formats:
+//   Pretty  the classic display (same text as printStudentDetailed)
+//   TSV     header line, then name, roll, branch, startYear, current
+//           courses ("a;b") and completed courses ("code:grade;...")
+//   JSONL   one JSON object per line
+//
+// offset / limit select a window of the records passed to write(), for
+// paging through large results.
+// ========================
+
+enum class OutputFormat { Pretty, TSV, JSONL };
+
+struct OutputOptions {
+    OutputFormat format = OutputFormat::Pretty;
+    std::size_t  offset = 0;
+    std::size_t  limit  = std::numeric_limits<std::size_t>::max();
+};
+
+class RecordWriter {
+private:
+    static constexpr std::size_t FLUSH_AT = 256 * 1024;
+
+    int           fd;
+    OutputOptions opts;
+    std::string   buffer;
+    std::size_t   seen    = 0;   // records offered to write()
+    std::size_t   written = 0;   // records actually emitted
+    bool          ok      = true;
+
+    // ---- Field encoders ----
+    template <typename T>
+    static void appendNumber(std::string &out, T v) {
+        char tmp[32];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+        out.append(tmp, res.ptr);
+    }
+
+    // Same digits as operator<< with the default precision (%g, 6)
+    static void appendPrettyDouble(std::string &out, double v) {
+        char tmp[32];
+        auto res = std::to_chars(tmp, tmp + sizeof(tmp), v, std::chars_format::general, 6);
+        out.append(tmp, res.ptr);
+    }
+
+    template <typename T>
+    static void appendText(std::string &out, const T &v) {
+        if constexpr (std::is_arithmetic_v<T>) appendNumber(out, v);
+        else out += std::string_view(v);
+    }
+
+    static void appendJsonString(std::string &out, std::string_view s) {
+        static const char hex[] = "0123456789abcdef";
+        out += '"';
+        for (char c : s) {
+            switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            case '\r': out += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += hex[(c >> 4) & 0xF];
+                    out += hex[c & 0xF];
+                } else {
+                    out += c;
+                }
+            }
+        }
+        out += '"';
+    }
+
+    template <typename T>
+    static void appendJsonValue(std::string &out, const T &v) {
+        if constexpr (std::is_arithmetic_v<T>) appendNumber(out, v);
+        else appendJsonString(out, std::string_view(v));
+    }
+
+    // TSV fields must not contain the separators
+    static void appendTsvText(std::string &out, std::string_view s) {
+        for (char c : s) out += (c == '\t' || c == '\n') ? ' ' : c;
+    }
+
+    bool writeAll(const char *p, std::size_t n) {
+        while (n > 0) {
+            ssize_t w = ::write(fd, p, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            p += w;
+            n -= static_cast<std::size_t>(w);
+        }
+        return true;
+    }
+
+public:
+    // Anything already queued on std::cout / stdout is flushed first, so
+    // the two never interleave
+    explicit RecordWriter(int fd = STDOUT_FILENO, OutputOptions opts = OutputOptions())
+        : fd(fd), opts(opts) {
+        std::cout.flush();
+        std::fflush(stdout);
+        buffer.reserve(FLUSH_AT + 4096);
+        if (opts.format == OutputFormat::TSV)
+            buffer += "name\troll\tbranch\tstartYear\tcurrentCourses\tcompletedCourses\n";
+    }
+
+    ~RecordWriter() { flush(); }
+
+    RecordWriter(const RecordWriter &) = delete;
+    RecordWriter &operator=(const RecordWriter &) = delete;
+
+    // Appends `s` in `format` to `out`. RecordT is a Student or a
+    // ColumnStore row view.
+    template <typename RecordT>
+    static void format(std::string &out, const RecordT &s, OutputFormat format) {
+        switch (format) {
+        case OutputFormat::Pretty: {
+            out += "Name: ";
+            out += s.getName();
+            out += ", Roll: ";
+            appendText(out, s.getRoll());
+            out += ", Branch: ";
+            out += s.getBranch();
+            out += ", StartYear: ";
+            appendNumber(out, s.getStartYear());
+            out += '\n';
+
+            const auto &current = s.getCurrentCourses();
+            if (!current.empty()) {
+                out += "    Current: ";
+                for (const auto &c : current) {
+                    appendText(out, c);
+                    out += ' ';
+                }
+                out += '\n';
+            }
+
+            const auto &completed = s.getCompletedCourses();
+            if (!completed.empty()) {
+                out += "    Completed: ";
+                for (const auto &p : completed) {
+                    out += '(';
+                    appendText(out, p.first);
+                    out += ", grade=";
+                    appendPrettyDouble(out, p.second);
+                    out += ") ";
+                }
+                out += '\n';
+            }
+            break;
+        }
+
+        case OutputFormat::TSV: {
+            appendTsvText(out, s.getName());
+            out += '\t';
+            appendText(out, s.getRoll());
+            out += '\t';
+            out += s.getBranch();
+            out += '\t';
+            appendNumber(out, s.getStartYear());
+            out += '\t';
+            bool first = true;
+            for (const auto &c : s.getCurrentCourses()) {
+                if (!first) out += ';';
+                appendText(out, c);
+                first = false;
+            }
+            out += '\t';
+            first = true;
+            for (const auto &p : s.getCompletedCourses()) {
+                if (!first) out += ';';
+                appendText(out, p.first);
+                out += ':';
+                appendNumber(out, p.second);
+                first = false;
+            }
+            out += '\n';
+            break;
+        }
+
+        case OutputFormat::JSONL: {
+            out += "{\"name\":";
+            appendJsonString(out, s.getName());
+            out += ",\"roll\":";
+            appendJsonValue(out, s.getRoll());
+            out += ",\"branch\":";
+            appendJsonString(out, s.getBranch());
+            out += ",\"startYear\":";
+            appendNumber(out, s.getStartYear());
+            out += ",\"current\":[";
+            bool first = true;
+            for (const auto &c : s.getCurrentCourses()) {
+                if (!first) out += ',';
+                appendJsonValue(out, c);
+                first = false;
+            }
+            out += "],\"completed\":[";
+            first = true;
+            for (const auto &p : s.getCompletedCourses()) {
+                if (!first) out += ',';
+                out += "{\"course\":";
+                appendJsonValue(out, p.first);
+                out += ",\"grade\":";
+                appendNumber(out, p.second);
+                out += '}';
+                first = false;
+            }
+            out += "]}\n";
+            break;
+        }
+        }
+    }
+
+    // Emits `s` if it falls inside the offset/limit window. Returns false
+    // once the window is exhausted, so callers can stop iterating.
+    template <typename RecordT>
+    bool write(const RecordT &s) {
+        if (written >= opts.limit) return false;
+        if (seen++ < opts.offset) return true;
+
+        format(buffer, s, opts.format);
+        ++written;
+        if (buffer.size() >= FLUSH_AT) flush();
+        return written < opts.limit;
+    }
+
+    // Raw text (banners, footers), kept in order with the records
+    void text(std::string_view t) {
+        buffer += t;
+        if (buffer.size() >= FLUSH_AT) flush();
+    }
+
+    bool flush() {
+        if (!buffer.empty()) {
+            ok = writeAll(buffer.data(), buffer.size()) && ok;
+            buffer.clear();
+        }
+        return ok;
+    }
+
+    std::size_t recordsWritten() const { return written; }
+    const OutputOptions &options() const { return opts; }
+};
+
+#endif // RECORD_WRITER_HPP
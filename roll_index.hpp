@@ -0,0 +1,273 @@
+#ifndef ROLL_INDEX_HPP
+#define ROLL_INDEX_HPP
+
+#include <vector>
+#include <functional>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Roll number hash index
+// Open addressing with linear probing over one flat slot array. A slot
+// holds the full 64-bit hash and a record index; the roll itself stays
+// in the record, so the index is 16 bytes per student whatever RollT is.
+// Erase uses backward-shift deletion, so the table never accumulates
+// deleted markers and probe chains stay short after many deletes.
+//
+// Duplicate rolls are allowed; find() returns the lowest row among them.
+// ========================
+
+template <typename RollT>
+class RollIndex {
+public:
+    static constexpr std::size_t NONE = std::numeric_limits<std::size_t>::max();
+
+private:
+    struct Slot {
+        std::uint64_t hash = 0;
+        std::size_t   row  = NONE;
+    };
+
+    std::vector<Slot> slots;      // size is zero or a power of two
+    std::size_t       count = 0;
+
+    // std::hash is the identity for integers; mix so consecutive rolls
+    // spread over the whole table (splitmix64 finaliser)
+    static std::uint64_t hashOf(const RollT &roll) {
+        std::uint64_t h = std::hash<RollT>()(roll);
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    std::size_t mask() const { return slots.size() - 1; }
+
+    // Keeps the load factor at or below 3/4, so probe chains stay short
+    void growFor(std::size_t n) {
+        std::size_t cap = slots.empty() ? 16 : slots.size();
+        while (n * 4 > cap * 3) cap *= 2;
+        if (cap != slots.size()) rehash(cap);
+    }
+
+    void rehash(std::size_t cap) {
+        std::vector<Slot> old(cap);
+        old.swap(slots);
+        for (const Slot &s : old)
+            if (s.row != NONE) place(s);
+    }
+
+    void place(const Slot &s) {
+        std::size_t i = s.hash & mask();
+        while (slots[i].row != NONE) i = (i + 1) & mask();
+        slots[i] = s;
+    }
+
+    // Slot holding `row` under `roll`'s hash, or NONE
+    std::size_t slotOf(const RollT &roll, std::size_t row) const {
+        if (slots.empty()) return NONE;
+        const std::uint64_t h = hashOf(roll);
+        for (std::size_t i = h & mask(); slots[i].row != NONE; i = (i + 1) & mask())
+            if (slots[i].hash == h && slots[i].row == row) return i;
+        return NONE;
+    }
+
+public:
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void clear() {
+        slots.clear();
+        count = 0;
+    }
+
+    // Sizes the table for `n` rows up front, so bulk builds never rehash
+    void reserve(std::size_t n) { growFor(n); }
+
+    // Indexes rows [0, n); `rollOf(row)` returns the roll of that record
+    template <typename RollOf>
+    void build(std::size_t n, RollOf rollOf) {
+        clear();
+        reserve(n);
+        for (std::size_t i = 0; i < n; ++i) insert(rollOf(i), i);
+    }
+
+    void insert(const RollT &roll, std::size_t row) {
+        growFor(count + 1);
+        place({hashOf(roll), row});
+        ++count;
+    }
+
+    // Removes the entry for (`roll`, `row`); false if there was none
+    bool erase(const RollT &roll, std::size_t row) {
+        std::size_t hole = slotOf(roll, row);
+        if (hole == NONE) return false;
+
+        // Backward shift: pull later chain members into the hole whenever
+        // the hole lies between their home slot and where they sit now
+        for (std::size_t i = (hole + 1) & mask(); slots[i].row != NONE;
+             i = (i + 1) & mask()) {
+            std::size_t home = slots[i].hash & mask();
+            if (((i - home) & mask()) >= ((i - hole) & mask())) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Slot();
+        --count;
+        return true;
+    }
+
+    // Lowest row whose roll equals `roll`, or NONE. `rollOf(row)` returns
+    // the roll stored in that record.
+    template <typename RollOf>
+    std::size_t find(const RollT &roll, RollOf rollOf) const {
+        std::size_t best = NONE;
+        if (slots.empty()) return best;
+        const std::uint64_t h = hashOf(roll);
+        for (std::size_t i = h & mask(); slots[i].row != NONE; i = (i + 1) & mask()) {
+            const std::size_t row = slots[i].row;
+            if (slots[i].hash == h && row < best && rollOf(row) == roll) best = row;
+        }
+        return best;
+    }
+
+    // Calls fn(row) for every row whose roll equals `roll`, in no
+    // particular order
+    template <typename RollOf, typename Fn>
+    void forEachMatch(const RollT &roll, RollOf rollOf, Fn fn) const {
+        if (slots.empty()) return;
+        const std::uint64_t h = hashOf(roll);
+        for (std::size_t i = h & mask(); slots[i].row != NONE; i = (i + 1) & mask())
+            if (slots[i].hash == h && rollOf(slots[i].row) == roll) fn(slots[i].row);
+    }
+};
+
+// ========================
+// Direct-addressed roll index (integral rolls)
+// Numeric rolls are usually handed out from a narrow block. When a build
+// finds the rolls spanning at most DENSITY slots per student, slot
+// roll - lo of one flat array holds the row: a lookup is a subtraction,
+// a bounds check and one load, with no hashing or probing.
+//
+// The array keeps the first row seen for each roll. Duplicates, rolls
+// outside the built range (later inserts) and whole sparse roll sets go
+// to a RollIndex, which lookups only consult while it is non-empty.
+// Same interface and semantics as RollIndex.
+// ========================
+
+template <typename RollT>
+class DenseRollIndex {
+    static_assert(std::is_integral<RollT>::value, "DenseRollIndex needs integral rolls");
+
+public:
+    static constexpr std::size_t NONE = RollIndex<RollT>::NONE;
+
+private:
+    static constexpr std::uint64_t DENSITY = 4;
+
+    using Ord = std::make_unsigned_t<RollT>;
+
+    Ord                      lo = 0;
+    std::vector<std::size_t> slots;      // slots[roll - lo] = row, or NONE
+    std::size_t              denseCount = 0;
+    RollIndex<RollT>         overflow;
+
+    // Offset of `roll` in the array (wraps to huge when roll < lo)
+    std::uint64_t offsetOf(const RollT &roll) const {
+        return static_cast<Ord>(static_cast<Ord>(roll) - lo);
+    }
+
+    std::size_t *slotOf(const RollT &roll) {
+        const std::uint64_t off = offsetOf(roll);
+        return off < slots.size() ? &slots[static_cast<std::size_t>(off)] : nullptr;
+    }
+
+    const std::size_t *slotOf(const RollT &roll) const {
+        return const_cast<DenseRollIndex *>(this)->slotOf(roll);
+    }
+
+public:
+    std::size_t size() const { return denseCount + overflow.size(); }
+    bool empty() const { return size() == 0; }
+
+    // True when a build found the rolls compact enough for the array
+    bool isDense() const { return !slots.empty(); }
+
+    void clear() {
+        slots.clear();
+        denseCount = 0;
+        overflow.clear();
+    }
+
+    void reserve(std::size_t n) { overflow.reserve(n); }
+
+    template <typename RollOf>
+    void build(std::size_t n, RollOf rollOf) {
+        clear();
+        if (n == 0) return;
+
+        RollT minRoll = rollOf(0), maxRoll = rollOf(0);
+        for (std::size_t i = 1; i < n; ++i) {
+            minRoll = std::min(minRoll, rollOf(i));
+            maxRoll = std::max(maxRoll, rollOf(i));
+        }
+        const std::uint64_t span =
+            static_cast<std::uint64_t>(static_cast<Ord>(static_cast<Ord>(maxRoll) -
+                                                        static_cast<Ord>(minRoll))) + 1;
+        if (span == 0 || span > DENSITY * n) {
+            overflow.build(n, rollOf);
+            return;
+        }
+
+        lo = static_cast<Ord>(minRoll);
+        slots.assign(static_cast<std::size_t>(span), NONE);
+        for (std::size_t i = 0; i < n; ++i) insert(rollOf(i), i);
+    }
+
+    void insert(const RollT &roll, std::size_t row) {
+        std::size_t *slot = slotOf(roll);
+        if (slot && *slot == NONE) {
+            *slot = row;
+            ++denseCount;
+        } else {
+            overflow.insert(roll, row);
+        }
+    }
+
+    bool erase(const RollT &roll, std::size_t row) {
+        std::size_t *slot = slotOf(roll);
+        if (slot && *slot == row) {
+            *slot = NONE;
+            --denseCount;
+            return true;
+        }
+        return overflow.erase(roll, row);
+    }
+
+    template <typename RollOf>
+    std::size_t find(const RollT &roll, RollOf rollOf) const {
+        const std::size_t *slot = slotOf(roll);
+        std::size_t best = slot ? *slot : NONE;
+        if (!overflow.empty()) best = std::min(best, overflow.find(roll, rollOf));
+        return best;
+    }
+
+    template <typename RollOf, typename Fn>
+    void forEachMatch(const RollT &roll, RollOf rollOf, Fn fn) const {
+        const std::size_t *slot = slotOf(roll);
+        if (slot && *slot != NONE) fn(*slot);
+        if (!overflow.empty()) overflow.forEachMatch(roll, rollOf, fn);
+    }
+};
+
+// The roll index a database uses, chosen at compile time
+template <typename RollT>
+using RollIndexFor = std::conditional_t<std::is_integral<RollT>::value &&
+                                            !std::is_same<RollT, bool>::value,
+                                        DenseRollIndex<RollT>, RollIndex<RollT>>;
+
+#endif // ROLL_INDEX_HPP
@@ -0,0 +1,321 @@
+#ifndef ROW_BITMAP_HPP
+#define ROW_BITMAP_HPP
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+
+// ========================
+// Compressed row bitmap
+// A set of row numbers split into 64K-row containers (Roaring layout).
+// Each container is either a sorted array of 16-bit offsets (sparse, up
+// to 4096 rows: 2 bytes per row) or a 1024-word bitset (dense: 8 KiB),
+// whichever is smaller. AND/OR/AND-NOT work container by container,
+// so whole 64K-row stretches absent from one side are skipped.
+// ========================
+
+class RowBitmap {
+private:
+    static constexpr std::size_t  WORDS     = 1024;   // 65536 bits
+    static constexpr std::uint32_t ARRAY_MAX = 4096;
+
+    struct Container {
+        std::size_t                high = 0;   // row >> 16
+        std::uint32_t              card = 0;
+        std::vector<std::uint16_t> array;      // sorted, when sparse
+        std::vector<std::uint64_t> bits;       // WORDS words, when dense
+
+        bool dense() const { return !bits.empty(); }
+
+        bool contains(std::uint16_t low) const {
+            if (dense()) return (bits[low >> 6] >> (low & 63)) & 1;
+            return std::binary_search(array.begin(), array.end(), low);
+        }
+
+        void toBitset() {
+            bits.assign(WORDS, 0);
+            for (auto v : array) bits[v >> 6] |= std::uint64_t(1) << (v & 63);
+            std::vector<std::uint16_t>().swap(array);
+        }
+
+        void toArray() {
+            array.clear();
+            array.reserve(card);
+            forEach([this](std::uint16_t v) { array.push_back(v); });
+            std::vector<std::uint64_t>().swap(bits);
+        }
+
+        // Picks the smaller representation for the current cardinality
+        void normalize() {
+            if (dense() && card <= ARRAY_MAX) toArray();
+            else if (!dense() && card > ARRAY_MAX) toBitset();
+        }
+
+        template <typename Fn>
+        void forEach(Fn fn) const {
+            if (!dense()) {
+                for (auto v : array) fn(v);
+                return;
+            }
+            for (std::size_t w = 0; w < WORDS; ++w) {
+                std::uint64_t word = bits[w];
+                while (word) {
+                    fn(static_cast<std::uint16_t>(w * 64 + __builtin_ctzll(word)));
+                    word &= word - 1;
+                }
+            }
+        }
+    };
+
+    std::vector<Container> containers;   // sorted by high
+
+    static std::size_t highOf(std::size_t row) { return row >> 16; }
+    static std::uint16_t lowOf(std::size_t row) { return static_cast<std::uint16_t>(row); }
+
+    // Container for `high`, or containers.end()
+    std::vector<Container>::const_iterator findContainer(std::size_t high) const {
+        auto it = std::lower_bound(
+            containers.begin(), containers.end(), high,
+            [](const Container &c, std::size_t h) { return c.high < h; });
+        return (it != containers.end() && it->high == high) ? it : containers.end();
+    }
+
+    static std::uint32_t popcount(const std::vector<std::uint64_t> &bits) {
+        std::uint32_t n = 0;
+        for (auto w : bits) n += static_cast<std::uint32_t>(__builtin_popcountll(w));
+        return n;
+    }
+
+    // ---- Container-level set operations ----
+    static Container andOf(const Container &a, const Container &b) {
+        Container r;
+        r.high = a.high;
+        if (a.dense() && b.dense()) {
+            r.bits.resize(WORDS);
+            for (std::size_t w = 0; w < WORDS; ++w) r.bits[w] = a.bits[w] & b.bits[w];
+            r.card = popcount(r.bits);
+        } else if (a.dense() || b.dense()) {
+            const Container &arr = a.dense() ? b : a;
+            const Container &set = a.dense() ? a : b;
+            for (auto v : arr.array)
+                if (set.contains(v)) r.array.push_back(v);
+            r.card = static_cast<std::uint32_t>(r.array.size());
+        } else {
+            std::set_intersection(a.array.begin(), a.array.end(),
+                                  b.array.begin(), b.array.end(),
+                                  std::back_inserter(r.array));
+            r.card = static_cast<std::uint32_t>(r.array.size());
+        }
+        r.normalize();
+        return r;
+    }
+
+    static Container orOf(const Container &a, const Container &b) {
+        Container r;
+        r.high = a.high;
+        if (!a.dense() && !b.dense() && a.card + b.card <= ARRAY_MAX) {
+            std::set_union(a.array.begin(), a.array.end(),
+                           b.array.begin(), b.array.end(),
+                           std::back_inserter(r.array));
+            r.card = static_cast<std::uint32_t>(r.array.size());
+            return r;
+        }
+        r = a;
+        if (!r.dense()) r.toBitset();
+        if (b.dense()) {
+            for (std::size_t w = 0; w < WORDS; ++w) r.bits[w] |= b.bits[w];
+        } else {
+            for (auto v : b.array) r.bits[v >> 6] |= std::uint64_t(1) << (v & 63);
+        }
+        r.card = popcount(r.bits);
+        r.normalize();
+        return r;
+    }
+
+    static Container andNotOf(const Container &a, const Container &b) {
+        Container r;
+        r.high = a.high;
+        if (a.dense()) {
+            r.bits = a.bits;
+            if (b.dense()) {
+                for (std::size_t w = 0; w < WORDS; ++w) r.bits[w] &= ~b.bits[w];
+            } else {
+                for (auto v : b.array) r.bits[v >> 6] &= ~(std::uint64_t(1) << (v & 63));
+            }
+            r.card = popcount(r.bits);
+        } else {
+            for (auto v : a.array)
+                if (!b.contains(v)) r.array.push_back(v);
+            r.card = static_cast<std::uint32_t>(r.array.size());
+        }
+        r.normalize();
+        return r;
+    }
+
+public:
+    bool empty() const { return containers.empty(); }
+    void clear() { containers.clear(); }
+
+    std::size_t cardinality() const {
+        std::size_t n = 0;
+        for (const auto &c : containers) n += c.card;
+        return n;
+    }
+
+    bool contains(std::size_t row) const {
+        auto it = findContainer(highOf(row));
+        return it != containers.end() && it->contains(lowOf(row));
+    }
+
+    // Appending rows in increasing order (bulk builds, new students) is
+    // the fast path: it only touches the last container.
+    void add(std::size_t row) {
+        const std::size_t high = highOf(row);
+        const std::uint16_t low = lowOf(row);
+
+        auto it = (!containers.empty() && containers.back().high == high)
+                      ? containers.end() - 1
+                      : std::lower_bound(
+                            containers.begin(), containers.end(), high,
+                            [](const Container &c, std::size_t h) { return c.high < h; });
+        if (it == containers.end() || it->high != high) {
+            it = containers.insert(it, Container());
+            it->high = high;
+        }
+
+        Container &c = *it;
+        if (c.dense()) {
+            std::uint64_t &word = c.bits[low >> 6];
+            std::uint64_t bit = std::uint64_t(1) << (low & 63);
+            if (!(word & bit)) {
+                word |= bit;
+                ++c.card;
+            }
+            return;
+        }
+
+        if (c.array.empty() || c.array.back() < low) {
+            c.array.push_back(low);
+        } else {
+            auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+            if (*pos == low) return;
+            c.array.insert(pos, low);
+        }
+        ++c.card;
+        if (c.card > ARRAY_MAX) c.toBitset();
+    }
+
+    void remove(std::size_t row) {
+        auto cit = findContainer(highOf(row));
+        if (cit == containers.end()) return;
+
+        auto it = containers.begin() + (cit - containers.cbegin());
+        Container &c = *it;
+        const std::uint16_t low = lowOf(row);
+        if (c.dense()) {
+            std::uint64_t &word = c.bits[low >> 6];
+            std::uint64_t bit = std::uint64_t(1) << (low & 63);
+            if (!(word & bit)) return;
+            word &= ~bit;
+        } else {
+            auto pos = std::lower_bound(c.array.begin(), c.array.end(), low);
+            if (pos == c.array.end() || *pos != low) return;
+            c.array.erase(pos);
+        }
+
+        if (--c.card == 0) containers.erase(it);
+        else if (c.dense() && c.card <= ARRAY_MAX) c.toArray();
+    }
+
+    // Moves every row of `tail` into this bitmap. All rows of `tail` must
+    // lie in later 64K-row blocks than the rows already here, as when
+    // per-chunk bitmaps built in parallel are stitched in chunk order.
+    void append(RowBitmap &&tail) {
+        if (containers.empty()) {
+            containers.swap(tail.containers);
+            return;
+        }
+        for (auto &c : tail.containers) containers.push_back(std::move(c));
+        tail.containers.clear();
+    }
+
+    // Calls fn(row) for every row, ascending
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (const auto &c : containers) {
+            const std::size_t base = c.high << 16;
+            c.forEach([&](std::uint16_t v) { fn(base + v); });
+        }
+    }
+
+    std::vector<std::size_t> toVector() const {
+        std::vector<std::size_t> rows;
+        rows.reserve(cardinality());
+        forEach([&rows](std::size_t r) { rows.push_back(r); });
+        return rows;
+    }
+
+    // Approximate heap footprint
+    std::size_t memoryBytes() const {
+        std::size_t n = containers.capacity() * sizeof(Container);
+        for (const auto &c : containers)
+            n += c.array.capacity() * sizeof(std::uint16_t) +
+                 c.bits.capacity() * sizeof(std::uint64_t);
+        return n;
+    }
+
+    // ------------------------
+    // Set operations
+    // ------------------------
+    friend RowBitmap operator&(const RowBitmap &a, const RowBitmap &b) {
+        RowBitmap r;
+        auto i = a.containers.begin(), j = b.containers.begin();
+        while (i != a.containers.end() && j != b.containers.end()) {
+            if (i->high < j->high) ++i;
+            else if (j->high < i->high) ++j;
+            else {
+                Container c = andOf(*i, *j);
+                if (c.card) r.containers.push_back(std::move(c));
+                ++i; ++j;
+            }
+        }
+        return r;
+    }
+
+    friend RowBitmap operator|(const RowBitmap &a, const RowBitmap &b) {
+        RowBitmap r;
+        auto i = a.containers.begin(), j = b.containers.begin();
+        while (i != a.containers.end() || j != b.containers.end()) {
+            if (j == b.containers.end() || (i != a.containers.end() && i->high < j->high))
+                r.containers.push_back(*i++);
+            else if (i == a.containers.end() || j->high < i->high)
+                r.containers.push_back(*j++);
+            else
+                r.containers.push_back(orOf(*i++, *j++));
+        }
+        return r;
+    }
+
+    // Rows of `a` that are not in `b`
+    friend RowBitmap andNot(const RowBitmap &a, const RowBitmap &b) {
+        RowBitmap r;
+        auto j = b.containers.begin();
+        for (const auto &c : a.containers) {
+            while (j != b.containers.end() && j->high < c.high) ++j;
+            if (j == b.containers.end() || j->high != c.high) {
+                r.containers.push_back(c);
+                continue;
+            }
+            Container d = andNotOf(c, *j);
+            if (d.card) r.containers.push_back(std::move(d));
+        }
+        return r;
+    }
+
+    RowBitmap &operator&=(const RowBitmap &o) { return *this = *this & o; }
+    RowBitmap &operator|=(const RowBitmap &o) { return *this = *this | o; }
+};
+
+#endif // ROW_BITMAP_HPP
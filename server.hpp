@@ -0,0 +1,380 @@
+#ifndef SERVER_HPP
+#define SERVER_HPP
+
+#include "command.hpp"
+#include "thread_pool.hpp"
+#include "versioned_database.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// ========================
+// Query server on a Unix domain socket
+// The database is loaded once and served from memory. One thread runs
+// an epoll loop that accepts connections and moves bytes; command lines
+// (see command.hpp) are executed on the thread pool against the latest
+// published version (versioned_database.hpp), so a RELOAD never blocks
+// readers.
+//
+// Requests may be pipelined: every complete line a connection has sent
+// is run as one batch, and replies come back in request order. A
+// connection has at most one batch in flight; lines arriving meanwhile
+// wait for the next one.
+//
+// SIGINT / SIGTERM (blocked by the caller, received via signalfd) or
+// stop() end run().
+// ========================
+
+template <typename DB>
+class QueryServer {
+public:
+    using Loader = std::function<void(DB &)>;
+
+    struct Stats {
+        std::uint64_t connections = 0;
+        std::uint64_t requests    = 0;
+    };
+
+private:
+    static constexpr std::uint64_t LISTEN_ID = 0, WAKE_ID = 1, SIGNAL_ID = 2;
+    static constexpr std::size_t   MAX_LINE  = 1 << 20;   // unterminated input cap
+    static constexpr std::size_t   MAX_INPUT = 4 * MAX_LINE;   // buffered input cap
+
+    struct Connection {
+        int         fd = -1;
+        std::string in;                 // received, not yet dispatched
+        std::string out;                // replies not yet sent
+        std::size_t outPos = 0;
+        bool        busy = false;       // a batch is running on the pool
+        bool        peerClosed = false;
+        bool        overlong = false;   // reply "too long" once earlier lines are done
+        std::uint32_t events = EPOLLIN | EPOLLRDHUP;   // current epoll interest
+    };
+
+    struct Done {
+        std::uint64_t id;
+        std::string   out;
+        std::size_t   requests;
+    };
+
+    VersionedDatabase<DB> &versions;
+    ThreadPool            &pool;
+    Loader                 loader;
+    std::string            path;
+
+    int listenFd = -1, epollFd = -1, wakeFd = -1, signalFd = -1;
+    std::unordered_map<std::uint64_t, Connection> conns;
+    std::uint64_t nextId = SIGNAL_ID + 1;
+
+    std::mutex        doneMutex;
+    std::vector<Done> done;
+    std::atomic<std::size_t> inFlight{0};
+    std::atomic<bool>        stopping{false};
+    Stats st;
+
+    bool watch(int fd, std::uint64_t id, std::uint32_t events, int op = EPOLL_CTL_ADD) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.u64 = id;
+        return epoll_ctl(epollFd, op, fd, &ev) == 0;
+    }
+
+    void wake() {
+        std::uint64_t one = 1;
+        ssize_t r = ::write(wakeFd, &one, sizeof(one));
+        (void)r;
+    }
+
+    void closeConnection(std::uint64_t id) {
+        auto it = conns.find(id);
+        if (it == conns.end()) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        ::close(it->second.fd);
+        conns.erase(it);
+    }
+
+    void acceptAll() {
+        for (;;) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;   // EAGAIN, or a connection that went away
+            const std::uint64_t id = nextId++;
+            if (!watch(fd, id, EPOLLIN | EPOLLRDHUP)) {
+                ::close(fd);
+                continue;
+            }
+            conns[id].fd = fd;
+            ++st.connections;
+        }
+    }
+
+    // Executes one batch of lines on a pool thread
+    void runBatch(std::uint64_t id, std::string lines) {
+        auto snap = versions.snapshot();
+        std::string out;
+        std::size_t requests = 0;
+        std::string_view rest(lines);
+        while (!rest.empty()) {
+            std::string_view line = popLine(rest);
+            if (!isCommandLine(line)) continue;
+            ++requests;
+
+            Command cmd;
+            std::string err;
+            if (!parseCommand(line, cmd, err)) {
+                CommandRunner<DB>::error(out, err);
+            } else if (cmd.kind == CommandKind::Reload) {
+                try {
+                    versions.rebuild(loader);
+                    snap = versions.snapshot();   // later lines see the new data
+                    CommandRunner<DB>::reply(out, 0, std::string());
+                } catch (const std::exception &e) {
+                    CommandRunner<DB>::error(out, e.what());
+                }
+            } else {
+                CommandRunner<DB>::run(*snap, cmd, out);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            done.push_back({id, std::move(out), requests});
+        }
+        wake();
+        inFlight.fetch_sub(1, std::memory_order_release);
+    }
+
+    // Hands every complete line to the pool, unless a batch is running
+    void dispatch(std::uint64_t id, Connection &c) {
+        if (c.busy) return;
+        if (c.overlong && c.in.empty()) {
+            CommandRunner<DB>::error(c.out, "request line too long");
+            c.overlong = false;
+            return;
+        }
+        if (c.peerClosed && !c.in.empty() && c.in.back() != '\n') c.in += '\n';
+        const std::size_t end = c.in.rfind('\n');
+        if (end == std::string::npos) return;
+
+        std::string batch = c.in.substr(0, end + 1);
+        c.in.erase(0, end + 1);
+        c.busy = true;
+        inFlight.fetch_add(1, std::memory_order_acquire);
+        pool.submit([this, id, batch = std::move(batch)]() mutable {
+            runBatch(id, std::move(batch));
+        });
+    }
+
+    // Sends what the socket takes; false if the connection was closed
+    bool flush(std::uint64_t id, Connection &c) {
+        while (c.outPos < c.out.size()) {
+            ssize_t n = ::send(c.fd, c.out.data() + c.outPos, c.out.size() - c.outPos,
+                               MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                closeConnection(id);
+                return false;
+            }
+            c.outPos += static_cast<std::size_t>(n);
+        }
+        if (c.outPos == c.out.size()) {
+            c.out.clear();
+            c.outPos = 0;
+        }
+
+        // Stop polling for input once the peer has shut down its side,
+        // or a half-closed socket would report readable forever. While a
+        // batch runs, or the buffer is full, unread input stays in the
+        // socket, so a fast client is throttled instead of buffered.
+        const bool wantInput = !c.peerClosed && !c.busy && c.in.size() < MAX_INPUT;
+        const std::uint32_t events = (wantInput ? EPOLLIN | EPOLLRDHUP : 0u) |
+                                     (c.out.empty() ? 0u : EPOLLOUT);
+        if (events != c.events) {
+            c.events = events;
+            watch(c.fd, id, events, EPOLL_CTL_MOD);
+        }
+        if (c.peerClosed && !c.busy && !c.overlong && c.out.empty() && c.in.empty()) {
+            closeConnection(id);
+            return false;
+        }
+        return true;
+    }
+
+    void readFrom(Connection &c) {
+        char buf[64 * 1024];
+        while (c.in.size() < MAX_INPUT) {
+            ssize_t n = ::recv(c.fd, buf, sizeof(buf), 0);
+            if (n > 0) {
+                c.in.append(buf, static_cast<std::size_t>(n));
+                continue;
+            }
+            if (n == 0) c.peerClosed = true;
+            else if (errno == EINTR) continue;
+            else if (errno != EAGAIN && errno != EWOULDBLOCK) c.peerClosed = true;
+            break;
+        }
+        // The unterminated tail is cut and the connection closed once the
+        // complete lines before it have been answered
+        const std::size_t nl = c.in.rfind('\n');
+        const std::size_t tail = nl == std::string::npos ? 0 : nl + 1;
+        if (c.in.size() - tail > MAX_LINE) {
+            c.in.erase(tail);
+            c.overlong = true;
+            c.peerClosed = true;
+        }
+    }
+
+    void collectDone() {
+        std::uint64_t count;
+        ssize_t r = ::read(wakeFd, &count, sizeof(count));
+        (void)r;
+
+        std::vector<Done> batch;
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            batch.swap(done);
+        }
+        for (auto &d : batch) {
+            st.requests += d.requests;
+            auto it = conns.find(d.id);
+            if (it == conns.end()) continue;   // closed while running
+            Connection &c = it->second;
+            c.out += d.out;
+            c.busy = false;
+            dispatch(d.id, c);
+            flush(d.id, c);
+        }
+    }
+
+    void cleanup() {
+        for (auto &kv : conns) ::close(kv.second.fd);
+        conns.clear();
+        for (int *fd : {&listenFd, &epollFd, &wakeFd, &signalFd}) {
+            if (*fd >= 0) ::close(*fd);
+            *fd = -1;
+        }
+        if (!path.empty()) ::unlink(path.c_str());
+    }
+
+public:
+    // `loader` fills an empty database; it serves RELOAD
+    QueryServer(VersionedDatabase<DB> &versions, ThreadPool &pool, Loader loader,
+                std::string socketPath)
+        : versions(versions), pool(pool), loader(std::move(loader)), path(std::move(socketPath)) {}
+
+    ~QueryServer() {
+        while (inFlight.load(std::memory_order_acquire) > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        cleanup();
+    }
+
+    QueryServer(const QueryServer &) = delete;
+    QueryServer &operator=(const QueryServer &) = delete;
+
+    // Binds the socket (replacing a stale one). With handleSignals, the
+    // caller must already have blocked SIGINT and SIGTERM in every thread.
+    bool start(bool handleSignals = true, std::string *error = nullptr) {
+        auto fail = [&](const char *what) {
+            if (error) *error = std::string(what) + ": " + std::strerror(errno);
+            cleanup();
+            return false;
+        };
+
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            errno = ENAMETOOLONG;
+            return fail("socket path");
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) return fail("socket");
+        ::unlink(path.c_str());
+        if (::bind(listenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+            return fail("bind");
+        if (::listen(listenFd, SOMAXCONN) < 0) return fail("listen");
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || wakeFd < 0) return fail("epoll");
+        if (!watch(listenFd, LISTEN_ID, EPOLLIN) || !watch(wakeFd, WAKE_ID, EPOLLIN))
+            return fail("epoll_ctl");
+
+        if (handleSignals) {
+            sigset_t mask;
+            sigemptyset(&mask);
+            sigaddset(&mask, SIGINT);
+            sigaddset(&mask, SIGTERM);
+            signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+            if (signalFd < 0 || !watch(signalFd, SIGNAL_ID, EPOLLIN)) return fail("signalfd");
+        }
+        return true;
+    }
+
+    // Serves until a signal or stop()
+    void run() {
+        epoll_event events[64];
+        while (!stopping.load(std::memory_order_acquire)) {
+            int n = epoll_wait(epollFd, events, 64, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            for (int i = 0; i < n; ++i) {
+                const std::uint64_t id = events[i].data.u64;
+                const std::uint32_t ev = events[i].events;
+
+                if (id == LISTEN_ID) {
+                    acceptAll();
+                } else if (id == WAKE_ID) {
+                    collectDone();
+                } else if (id == SIGNAL_ID) {
+                    stopping = true;
+                } else {
+                    auto it = conns.find(id);
+                    if (it == conns.end()) continue;
+                    Connection &c = it->second;
+                    if (ev & (EPOLLERR | EPOLLHUP)) {
+                        closeConnection(id);
+                        continue;
+                    }
+                    if (ev & (EPOLLIN | EPOLLRDHUP)) readFrom(c);
+                    dispatch(id, c);
+                    flush(id, c);
+                }
+            }
+        }
+    }
+
+    // Thread-safe: makes run() return
+    void stop() {
+        stopping = true;
+        if (wakeFd >= 0) wake();
+    }
+
+    // Only meaningful once run() has returned
+    const Stats &stats() const { return st; }
+};
+
+#endif // SERVER_HPP
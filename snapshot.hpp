@@ -0,0 +1,343 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "student.hpp"
+#include "mapped_file.hpp"
+
+#include <string>
+#include <string_view>
+#include <memory_resource>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ========================
+// Binary snapshot format (version 1)
+//
+//   SnapshotHeader
+//   uint64_t        stringOffsets[stringCount + 1]
+//   char            stringData[stringBytes]      (padded to 8 bytes)
+//   SnapshotRecord  records[studentCount]
+//   uint64_t        currentCourses[currentCount]
+//   SnapshotGrade   completedCourses[completedCount]
+//
+// Names, branches and string keys live once in the string table and are
+// referenced by id. Integral rolls/course codes are stored inline.
+// Multi-byte fields use host byte order; the CSV stays the portable
+// interchange format and the snapshot is only a local cache of it.
+// ========================
+
+constexpr char          SNAPSHOT_MAGIC[8] = {'O', 'O', 'P', 'D', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t SNAPSHOT_VERSION  = 1;
+
+// Flag bits recording how keys were encoded, so a snapshot written by a
+// StudentDatabase<std::string, ...> is not read back as integral rolls.
+constexpr std::uint32_t SNAPSHOT_ROLL_IS_STRING   = 1u << 0;
+constexpr std::uint32_t SNAPSHOT_COURSE_IS_STRING = 1u << 1;
+
+struct SnapshotHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t studentCount;
+    std::uint64_t stringCount;
+    std::uint64_t stringBytes;
+    std::uint64_t currentCount;
+    std::uint64_t completedCount;
+};
+
+struct SnapshotRecord {
+    std::uint64_t roll;             // string id or integral value
+    std::uint64_t currentBegin;     // index into currentCourses
+    std::uint64_t completedBegin;   // index into completedCourses
+    std::uint32_t nameId;
+    std::uint32_t branchId;
+    std::int32_t  startYear;
+    std::uint16_t currentCount;
+    std::uint16_t completedCount;
+};
+
+struct SnapshotGrade {
+    std::uint64_t course;           // string id or integral value
+    double        grade;
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "header must keep 8-byte alignment");
+static_assert(sizeof(SnapshotRecord) == 40, "record layout changed");
+static_assert(sizeof(SnapshotGrade)  == 16, "grade layout changed");
+
+inline std::size_t snapshotPad8(std::size_t n) { return (n + 7) & ~std::size_t(7); }
+
+template <typename KeyT>
+constexpr bool snapshotKeyIsString() {
+    static_assert(std::is_same<KeyT, std::string>::value ||
+                  std::is_integral<KeyT>::value,
+                  "Snapshot keys must be std::string or integral");
+    return std::is_same<KeyT, std::string>::value;
+}
+
+// Deduplicating string table used while writing
+class SnapshotStringTable {
+private:
+    std::vector<std::uint64_t> offsets{0};
+    std::string data;
+    std::unordered_map<std::string, std::uint32_t> ids;
+
+public:
+    std::uint32_t intern(const std::string &s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+
+        auto id = static_cast<std::uint32_t>(offsets.size() - 1);
+        data += s;
+        offsets.push_back(data.size());
+        ids.emplace(s, id);
+        return id;
+    }
+
+    std::uint64_t count() const { return offsets.size() - 1; }
+    const std::vector<std::uint64_t> &getOffsets() const { return offsets; }
+    const std::string &getData() const { return data; }
+};
+
+template <typename KeyT>
+std::uint64_t encodeSnapshotKey(const KeyT &key, SnapshotStringTable &strings) {
+    if constexpr (snapshotKeyIsString<KeyT>()) {
+        return strings.intern(key);
+    } else {
+        return static_cast<std::uint64_t>(key);
+    }
+}
+
+// ========================
+// Writer
+// Written to "<path>.tmp", synced, and renamed, so readers never observe
+// a half-written snapshot, before or after a crash.
+// ========================
+template <typename RollT, typename CourseCodeT>
+bool writeSnapshot(const std::string &path,
+                   const std::vector<Student<RollT, CourseCodeT>> &students) {
+    SnapshotStringTable strings;
+    std::vector<SnapshotRecord> records;
+    std::vector<std::uint64_t>  current;
+    std::vector<SnapshotGrade>  completed;
+    records.reserve(students.size());
+
+    for (const auto &s : students) {
+        if (s.getCurrentCourses().size() > UINT16_MAX ||
+            s.getCompletedCourses().size() > UINT16_MAX) {
+            std::cerr << "Snapshot: too many courses for roll "
+                      << s.getRoll() << "\n";
+            return false;
+        }
+
+        SnapshotRecord r{};
+        r.roll           = encodeSnapshotKey(s.getRoll(), strings);
+        r.currentBegin   = current.size();
+        r.completedBegin = completed.size();
+        r.nameId         = strings.intern(std::string(s.getName()));
+        r.branchId       = strings.intern(s.getBranch());
+        r.startYear      = s.getStartYear();
+        r.currentCount   = static_cast<std::uint16_t>(s.getCurrentCourses().size());
+        r.completedCount = static_cast<std::uint16_t>(s.getCompletedCourses().size());
+
+        for (const auto &c : s.getCurrentCourses())
+            current.push_back(encodeSnapshotKey(c, strings));
+        for (const auto &p : s.getCompletedCourses())
+            completed.push_back({encodeSnapshotKey(p.first, strings), p.second});
+
+        records.push_back(r);
+    }
+
+    SnapshotHeader h{};
+    std::memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version        = SNAPSHOT_VERSION;
+    h.flags          = (snapshotKeyIsString<RollT>() ? SNAPSHOT_ROLL_IS_STRING : 0) |
+                       (snapshotKeyIsString<CourseCodeT>() ? SNAPSHOT_COURSE_IS_STRING : 0);
+    h.studentCount   = records.size();
+    h.stringCount    = strings.count();
+    h.stringBytes    = strings.getData().size();
+    h.currentCount   = current.size();
+    h.completedCount = completed.size();
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        const int out = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (out < 0) {
+            std::cerr << "Could not write snapshot: " << tmpPath << "\n";
+            return false;
+        }
+
+        static const char zeros[8] = {};
+        bool ok = true;
+        auto writeBytes = [&](const void *p, std::size_t n) {
+            const char *c = static_cast<const char *>(p);
+            while (ok && n > 0) {
+                const ssize_t w = ::write(out, c, n);
+                if (w < 0) {
+                    ok = errno == EINTR;
+                    continue;
+                }
+                c += w;
+                n -= static_cast<std::size_t>(w);
+            }
+        };
+
+        writeBytes(&h, sizeof(h));
+        writeBytes(strings.getOffsets().data(),
+                   strings.getOffsets().size() * sizeof(std::uint64_t));
+        writeBytes(strings.getData().data(), strings.getData().size());
+        writeBytes(zeros, snapshotPad8(h.stringBytes) - h.stringBytes);
+        writeBytes(records.data(),   records.size()   * sizeof(SnapshotRecord));
+        writeBytes(current.data(),   current.size()   * sizeof(std::uint64_t));
+        writeBytes(completed.data(), completed.size() * sizeof(SnapshotGrade));
+
+        // Synced before the rename: otherwise a crash can leave the new
+        // name pointing at a file whose data never reached the disk
+        ok = ok && ::fdatasync(out) == 0;
+        ok = ::close(out) == 0 && ok;
+        if (!ok) {
+            std::cerr << "Could not write snapshot: " << tmpPath << "\n";
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Could not replace snapshot: " << path << "\n";
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ========================
+// Reader
+// The file is memory-mapped; every section is bounds-checked against the
+// mapping before any record is decoded.
+// ========================
+template <typename RollT, typename CourseCodeT>
+bool readSnapshot(const std::string &path,
+                  std::vector<Student<RollT, CourseCodeT>> &students,
+                  std::pmr::memory_resource *mr = std::pmr::get_default_resource()) {
+    using StudentT = Student<RollT, CourseCodeT>;
+
+    MappedFile file(path);
+    if (!file.isOpen() || file.size() < sizeof(SnapshotHeader)) return false;
+
+    const char *base = file.data();
+    const std::size_t size = file.size();
+
+    SnapshotHeader h;
+    std::memcpy(&h, base, sizeof(h));
+
+    const std::uint32_t expectedFlags =
+        (snapshotKeyIsString<RollT>() ? SNAPSHOT_ROLL_IS_STRING : 0) |
+        (snapshotKeyIsString<CourseCodeT>() ? SNAPSHOT_COURSE_IS_STRING : 0);
+
+    if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != SNAPSHOT_VERSION || h.flags != expectedFlags) {
+        return false;
+    }
+
+    // Section layout; reject anything that does not fit the file exactly
+    const std::size_t offsetsPos   = sizeof(SnapshotHeader);
+    const std::size_t stringsPos   = offsetsPos + (h.stringCount + 1) * sizeof(std::uint64_t);
+    const std::size_t recordsPos   = stringsPos + snapshotPad8(h.stringBytes);
+    const std::size_t currentPos   = recordsPos + h.studentCount * sizeof(SnapshotRecord);
+    const std::size_t completedPos = currentPos + h.currentCount * sizeof(std::uint64_t);
+    const std::size_t endPos       = completedPos + h.completedCount * sizeof(SnapshotGrade);
+
+    if (h.stringCount > size || h.stringBytes > size || h.studentCount > size ||
+        h.currentCount > size || h.completedCount > size || endPos != size) {
+        return false;
+    }
+
+    auto stringAt = [&](std::uint64_t id, std::string_view &out) {
+        if (id >= h.stringCount) return false;
+        std::uint64_t range[2];
+        std::memcpy(range, base + offsetsPos + id * sizeof(std::uint64_t), sizeof(range));
+        if (range[0] > range[1] || range[1] > h.stringBytes) return false;
+        out = std::string_view(base + stringsPos + range[0], range[1] - range[0]);
+        return true;
+    };
+
+    auto decodeKey = [&](std::uint64_t raw, auto &out) {
+        using KeyT = std::decay_t<decltype(out)>;
+        if constexpr (snapshotKeyIsString<KeyT>()) {
+            std::string_view sv;
+            if (!stringAt(raw, sv)) return false;
+            out.assign(sv.data(), sv.size());
+        } else {
+            out = static_cast<KeyT>(raw);
+        }
+        return true;
+    };
+
+    std::vector<StudentT> loaded;
+    loaded.reserve(h.studentCount);
+
+    for (std::uint64_t i = 0; i < h.studentCount; ++i) {
+        SnapshotRecord r;
+        std::memcpy(&r, base + recordsPos + i * sizeof(SnapshotRecord), sizeof(r));
+
+        std::string_view name, branch;
+        RollT roll{};
+        // Written as begin > total || count > total - begin, so a corrupt
+        // begin near 2^64 cannot wrap the sum past the check
+        if (!stringAt(r.nameId, name) || !stringAt(r.branchId, branch) ||
+            !decodeKey(r.roll, roll) ||
+            r.currentBegin > h.currentCount ||
+            r.currentCount > h.currentCount - r.currentBegin ||
+            r.completedBegin > h.completedCount ||
+            r.completedCount > h.completedCount - r.completedBegin) {
+            return false;
+        }
+
+        StudentT &s = loaded.emplace_back(name, roll, std::string(branch), r.startYear,
+                                          typename StudentT::allocator_type(mr));
+
+        for (std::uint64_t j = 0; j < r.currentCount; ++j) {
+            std::uint64_t raw;
+            std::memcpy(&raw, base + currentPos +
+                        (r.currentBegin + j) * sizeof(std::uint64_t), sizeof(raw));
+            CourseCodeT course{};
+            if (!decodeKey(raw, course)) return false;
+            s.enrollInCourse(course);
+        }
+
+        for (std::uint64_t j = 0; j < r.completedCount; ++j) {
+            SnapshotGrade g;
+            std::memcpy(&g, base + completedPos +
+                        (r.completedBegin + j) * sizeof(SnapshotGrade), sizeof(g));
+            CourseCodeT course{};
+            if (!decodeKey(g.course, course)) return false;
+            s.completeCourse(course, g.grade);
+        }
+    }
+
+    students = std::move(loaded);
+    return true;
+}
+
+// A snapshot is reusable while it is at least as new as its source CSV
+inline bool snapshotIsFresh(const std::string &snapshotPath,
+                            const std::string &csvPath) {
+    struct stat snap {}, csv {};
+    if (::stat(snapshotPath.c_str(), &snap) != 0) return false;
+    if (::stat(csvPath.c_str(), &csv) != 0) return true;   // CSV gone: keep cache
+
+    if (snap.st_mtim.tv_sec != csv.st_mtim.tv_sec)
+        return snap.st_mtim.tv_sec > csv.st_mtim.tv_sec;
+    return snap.st_mtim.tv_nsec >= csv.st_mtim.tv_nsec;
+}
+
+#endif // SNAPSHOT_HPP
@@ -1,74 +1,229 @@
-#ifndef STUDENT_HPP
-#define STUDENT_HPP
-
-#include <string>
-#include <vector>
-#include <map>
-#include <algorithm>
-#include <iostream>
-
-// ========================
-// Template Student class (Q1)
-// ========================
-
-template <typename RollT, typename CourseCodeT>
-class Student {
-private:
-    std::string name;
-    RollT roll;
-    std::string branch;
-    int startYear;
-
-    std::vector<CourseCodeT> currentCourses;
-    std::map<CourseCodeT, double> completedCourses;  // course -> grade
-
-public:
-    Student() = default;
-
-    Student(const std::string &name,
-            const RollT &roll,
-            const std::string &branch,
-            int startYear)
-        : name(name), roll(roll), branch(branch), startYear(startYear) {}
-
-    // Getters – abstraction & data hiding
-    const std::string &getName() const { return name; }
-    const RollT &getRoll() const { return roll; }
-    const std::string &getBranch() const { return branch; }
-    int getStartYear() const { return startYear; }
-
-    const std::vector<CourseCodeT> &getCurrentCourses() const {
-        return currentCourses;
-    }
-
-    const std::map<CourseCodeT, double> &getCompletedCourses() const {
-        return completedCourses;
-    }
-
-    // Behavior
-    void enrollInCourse(const CourseCodeT &course) {
-        currentCourses.push_back(course);
-    }
-
-    void completeCourse(const CourseCodeT &course, double grade) {
-        // remove from current if present
-        auto it = std::find(currentCourses.begin(), currentCourses.end(), course);
-        if (it != currentCourses.end()) {
-            currentCourses.erase(it);
-        }
-        completedCourses[course] = grade;
-    }
-};
-
-// Pretty-print a Student (for demo)
-template <typename RollT, typename CourseCodeT>
-std::ostream &operator<<(std::ostream &os,
-                         const Student<RollT, CourseCodeT> &s) {
-    os << "Name: " << s.getName()
-       << ", Roll: " << s.getRoll()
-       << ", Branch: " << s.getBranch()
-       << ", StartYear: " << s.getStartYear();
-    return os;
-}
-
-#endif // STUDENT_HPP
+#ifndef STUDENT_HPP
+#define STUDENT_HPP
+
+#include "symbol_table.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+
+// ========================
+// Course list ranges
+// Records store interned course keys; these ranges decode them back to
+// CourseCodeT while iterating, so callers still see course codes.
+// ========================
+
+template <typename CourseCodeT>
+class CourseCodeRange {
+public:
+    using Traits = CourseKeyTraits<CourseCodeT>;
+    using Key    = typename Traits::Key;
+
+private:
+    const Key *first, *last;
+
+public:
+    class iterator {
+    private:
+        const Key *p;
+
+    public:
+        explicit iterator(const Key *p) : p(p) {}
+        const CourseCodeT &operator*() const { return Traits::code(*p); }
+        iterator &operator++() { ++p; return *this; }
+        bool operator!=(const iterator &o) const { return p != o.p; }
+        bool operator==(const iterator &o) const { return p == o.p; }
+    };
+
+    CourseCodeRange(const Key *first, const Key *last) : first(first), last(last) {}
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(last); }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+template <typename CourseCodeT>
+class CourseGradeRange {
+public:
+    using Traits = CourseKeyTraits<CourseCodeT>;
+    using Key    = typename Traits::Key;
+    using Entry  = std::pair<Key, double>;
+
+private:
+    const Entry *first, *last;
+
+public:
+    class iterator {
+    private:
+        const Entry *p;
+
+    public:
+        explicit iterator(const Entry *p) : p(p) {}
+        std::pair<const CourseCodeT &, double> operator*() const {
+            return {Traits::code(p->first), p->second};
+        }
+        iterator &operator++() { ++p; return *this; }
+        bool operator!=(const iterator &o) const { return p != o.p; }
+        bool operator==(const iterator &o) const { return p == o.p; }
+    };
+
+    CourseGradeRange(const Entry *first, const Entry *last) : first(first), last(last) {}
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(last); }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// ========================
+// Template Student class (Q1)
+// Branch and course codes are interned (see symbol_table.hpp): the record
+// holds a 16-bit branch id and integer course keys, and completed courses
+// are a small vector kept sorted by course code (the order std::map gave).
+//
+// The name and course lists use std::pmr containers, so a loader can
+// place a whole dataset in one arena (see arena_vector.hpp). Copies go to
+// the default heap; moves keep the source's allocator, so records moved
+// between vectors never leave their arena.
+// ========================
+
+template <typename RollT, typename CourseCodeT>
+class Student {
+public:
+    using KeyTraits  = CourseKeyTraits<CourseCodeT>;
+    using CourseKey  = typename KeyTraits::Key;
+    using GradeEntry = std::pair<CourseKey, double>;
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+private:
+    std::pmr::string name;
+    RollT roll{};
+    BranchId branch = SymbolTable<BranchId>::NONE;
+    int startYear = 0;
+
+    std::pmr::vector<CourseKey>  currentCourses;
+    std::pmr::vector<GradeEntry> completedCourses;  // course -> grade, by code
+
+public:
+    Student() = default;
+
+    Student(std::string_view name,
+            const RollT &roll,
+            const std::string &branch,
+            int startYear,
+            const allocator_type &alloc = allocator_type())
+        : name(name, alloc), roll(roll), branch(branchSymbols().intern(branch)),
+          startYear(startYear), currentCourses(alloc), completedCourses(alloc) {}
+
+    Student(std::string_view name, const RollT &roll, BranchId branch, int startYear,
+            const allocator_type &alloc = allocator_type())
+        : name(name, alloc), roll(roll), branch(branch), startYear(startYear),
+          currentCourses(alloc), completedCourses(alloc) {}
+
+    Student(const Student &) = default;
+    Student(Student &&) noexcept = default;
+    Student &operator=(const Student &) = default;
+
+    // Allocator-extended copy (e.g. into an arena)
+    Student(const Student &o, const allocator_type &alloc)
+        : name(o.name, alloc), roll(o.roll), branch(o.branch), startYear(o.startYear),
+          currentCourses(o.currentCourses, alloc),
+          completedCourses(o.completedCourses, alloc) {}
+
+    // Takes over o's storage and allocator, as std::allocator types do;
+    // std::pmr's own move assignment would copy between arenas
+    Student &operator=(Student &&o) noexcept {
+        if (this != &o) {
+            this->~Student();
+            ::new (static_cast<void *>(this)) Student(std::move(o));
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const { return name.get_allocator(); }
+
+    // Getters – abstraction & data hiding
+    std::string_view getName() const { return name; }
+    const RollT &getRoll() const { return roll; }
+    const std::string &getBranch() const { return branchName(branch); }
+    BranchId getBranchId() const { return branch; }
+    int getStartYear() const { return startYear; }
+
+    CourseCodeRange<CourseCodeT> getCurrentCourses() const {
+        return {currentCourses.data(), currentCourses.data() + currentCourses.size()};
+    }
+
+    CourseGradeRange<CourseCodeT> getCompletedCourses() const {
+        return {completedCourses.data(),
+                completedCourses.data() + completedCourses.size()};
+    }
+
+    // Interned keys, for integer comparisons at call sites
+    const std::pmr::vector<CourseKey> &getCurrentCourseKeys() const {
+        return currentCourses;
+    }
+
+    const std::pmr::vector<GradeEntry> &getCompletedCourseKeys() const {
+        return completedCourses;
+    }
+
+    // Grade for a completed course, or nullptr
+    const double *findGrade(CourseKey course) const {
+        for (const auto &e : completedCourses)
+            if (e.first == course) return &e.second;
+        return nullptr;
+    }
+
+    // Behavior
+    void enrollInCourse(const CourseCodeT &course) {
+        enrollInCourseKey(KeyTraits::intern(course));
+    }
+
+    void enrollInCourseKey(CourseKey course) {
+        currentCourses.push_back(course);
+    }
+
+    void completeCourse(const CourseCodeT &course, double grade) {
+        completeCourseKey(KeyTraits::intern(course), grade);
+    }
+
+    void completeCourseKey(CourseKey course, double grade) {
+        // remove from current if present
+        auto it = std::find(currentCourses.begin(), currentCourses.end(), course);
+        if (it != currentCourses.end()) {
+            currentCourses.erase(it);
+        }
+
+        auto pos = std::lower_bound(
+            completedCourses.begin(), completedCourses.end(), course,
+            [](const GradeEntry &e, CourseKey k) { return KeyTraits::less(e.first, k); });
+        if (pos != completedCourses.end() && pos->first == course)
+            pos->second = grade;
+        else
+            completedCourses.insert(pos, {course, grade});
+    }
+};
+
+// One-line summary; works for Student and for row views that expose
+// the same getters (e.g. ColumnStore::StudentView)
+template <typename RecordT>
+std::ostream &writeStudentSummary(std::ostream &os, const RecordT &s) {
+    os << "Name: " << s.getName()
+       << ", Roll: " << s.getRoll()
+       << ", Branch: " << s.getBranch()
+       << ", StartYear: " << s.getStartYear();
+    return os;
+}
+
+// Pretty-print a Student (for demo)
+template <typename RollT, typename CourseCodeT>
+std::ostream &operator<<(std::ostream &os,
+                         const Student<RollT, CourseCodeT> &s) {
+    return writeStudentSummary(os, s);
+}
+
+#endif // STUDENT_HPP
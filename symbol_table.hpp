@@ -0,0 +1,200 @@
+#ifndef SYMBOL_TABLE_HPP
+#define SYMBOL_TABLE_HPP
+
+#include "csv_parse.hpp"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cctype>
+
+// ========================
+// Global symbol tables (string interning)
+// Branches and course codes come from tiny vocabularies, so each distinct
+// string is stored once and records keep a dense integer id instead.
+// Every symbol also remembers the id of its case-folded (lower-case)
+// spelling, so case-insensitive matches are a single integer compare.
+//
+// Thread-safe: intern()/find() take a shared/unique lock on the lookup
+// map; name()/folded() are lock-free because entries never move once
+// published.
+// ========================
+
+template <typename IdT>
+class SymbolTable {
+    static_assert(std::is_unsigned<IdT>::value, "symbol ids must be unsigned");
+
+public:
+    static constexpr IdT NONE = std::numeric_limits<IdT>::max();
+
+private:
+    struct Entry {
+        std::string text;
+        IdT folded = NONE;
+    };
+
+    static constexpr std::size_t CHUNK_BITS  = 10;
+    static constexpr std::size_t CHUNK_SIZE  = std::size_t(1) << CHUNK_BITS;
+    static constexpr std::size_t MAX_SYMBOLS =
+        std::size_t(NONE) < (std::size_t(1) << 22) ? std::size_t(NONE)
+                                                   : (std::size_t(1) << 22);
+    static constexpr std::size_t MAX_CHUNKS  = (MAX_SYMBOLS + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    std::atomic<Entry *>     chunks[MAX_CHUNKS] = {};
+    std::atomic<std::size_t> count{0};
+
+    mutable std::shared_mutex                  mutex;
+    std::unordered_map<std::string_view, IdT>  ids;   // views into Entry::text
+
+    Entry &entry(IdT id) const {
+        return chunks[id >> CHUNK_BITS].load(std::memory_order_acquire)
+                     [id & (CHUNK_SIZE - 1)];
+    }
+
+    // Caller holds the unique lock
+    IdT insertLocked(std::string_view s) {
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+
+        std::size_t n = count.load(std::memory_order_relaxed);
+        if (n >= MAX_SYMBOLS)
+            throw std::length_error("SymbolTable: too many distinct symbols");
+
+        std::size_t c = n >> CHUNK_BITS;
+        if (!chunks[c].load(std::memory_order_relaxed))
+            chunks[c].store(new Entry[CHUNK_SIZE], std::memory_order_release);
+
+        auto id = static_cast<IdT>(n);
+        Entry &e = chunks[c].load(std::memory_order_relaxed)[n & (CHUNK_SIZE - 1)];
+        e.text.assign(s.data(), s.size());
+        ids.emplace(std::string_view(e.text), id);
+        count.store(n + 1, std::memory_order_release);
+
+        std::string lower = foldCase(s);
+        e.folded = (lower == s) ? id : insertLocked(lower);
+        return id;
+    }
+
+public:
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+
+    ~SymbolTable() {
+        for (auto &c : chunks) delete[] c.load();
+    }
+
+    static std::string foldCase(std::string_view s) {
+        std::string out(s);
+        for (char &ch : out)
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        return out;
+    }
+
+    // Returns the id of `s`, adding it on first sight
+    IdT intern(std::string_view s) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(s);
+            if (it != ids.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        return insertLocked(s);
+    }
+
+    // Returns NONE if `s` was never interned
+    IdT find(std::string_view s) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(s);
+        return it == ids.end() ? NONE : it->second;
+    }
+
+    // Id of the case-folded spelling of `s`, or NONE if no interned
+    // symbol folds to it
+    IdT findFolded(std::string_view s) const {
+        return find(foldCase(s));
+    }
+
+    const std::string &name(IdT id) const { return entry(id).text; }
+    IdT folded(IdT id) const { return entry(id).folded; }
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+};
+
+using BranchId = std::uint16_t;
+using CourseId = std::uint32_t;
+
+inline SymbolTable<BranchId> &branchSymbols() {
+    static SymbolTable<BranchId> table;
+    return table;
+}
+
+// Name of a branch id; the empty string for NONE (a record with no branch)
+inline const std::string &branchName(BranchId id) {
+    static const std::string none;
+    return id == SymbolTable<BranchId>::NONE ? none : branchSymbols().name(id);
+}
+
+inline SymbolTable<CourseId> &courseSymbols() {
+    static SymbolTable<CourseId> table;
+    return table;
+}
+
+// ========================
+// Course key traits
+// How a CourseCodeT is stored inside records: string codes become dense
+// CourseIds from courseSymbols(); integral codes are already dense
+// integers and are stored as-is.
+// ========================
+template <typename CourseCodeT, typename Enable = void>
+struct CourseKeyTraits;
+
+template <>
+struct CourseKeyTraits<std::string> {
+    using Key = CourseId;
+    static constexpr Key NONE = SymbolTable<CourseId>::NONE;
+
+    static Key intern(const std::string &code) { return courseSymbols().intern(code); }
+    static Key find(const std::string &code) { return courseSymbols().find(code); }
+    static const std::string &code(Key k) { return courseSymbols().name(k); }
+    static Key folded(Key k) { return courseSymbols().folded(k); }
+    static Key findFolded(const std::string &code) { return courseSymbols().findFolded(code); }
+    static bool less(Key a, Key b) { return a != b && code(a) < code(b); }
+
+    // Interns straight from a CSV slice, without a temporary string
+    static bool parse(std::string_view s, Key &out) {
+        out = courseSymbols().intern(s);
+        return true;
+    }
+    // Whether parse() would accept `s`; interns nothing
+    static bool valid(std::string_view) { return true; }
+};
+
+template <typename CourseCodeT>
+struct CourseKeyTraits<CourseCodeT,
+                       std::enable_if_t<std::is_integral<CourseCodeT>::value>> {
+    using Key = CourseCodeT;
+    static constexpr Key NONE = std::numeric_limits<Key>::max();
+
+    static Key intern(const CourseCodeT &code) { return code; }
+    static Key find(const CourseCodeT &code) { return code; }
+    static const CourseCodeT &code(const Key &k) { return k; }
+    static Key folded(Key k) { return k; }
+    static Key findFolded(const CourseCodeT &code) { return code; }
+    static bool less(Key a, Key b) { return a < b; }
+
+    static bool parse(std::string_view s, Key &out) { return parseNumber(s, out); }
+    static bool valid(std::string_view s) {
+        Key k;
+        return parseNumber(s, k);
+    }
+};
+
+#endif // SYMBOL_TABLE_HPP
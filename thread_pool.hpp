@@ -0,0 +1,259 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <chrono>
+#include <exception>
+#include <algorithm>
+#include <cstddef>
+
+// ========================
+// Work-stealing thread pool
+// Every worker owns a deque: it pushes and pops its own tasks at the back
+// (LIFO, cache-warm) while idle workers steal from the front of other
+// deques. Threads are created once and live as long as the pool, so
+// database operations only pay for task hand-off, not thread start-up.
+//
+// A thread that waits in parallelFor() keeps executing queued tasks
+// until its batch finishes, so nested parallel calls cannot deadlock.
+// ========================
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // Cumulative per-worker activity since construction or resetStats()
+    struct WorkerStats {
+        long long   busyMicros = 0;
+        long long   idleMicros = 0;
+        std::size_t tasks      = 0;
+        std::size_t steals     = 0;
+    };
+
+private:
+    struct alignas(64) Worker {
+        std::mutex       mutex;
+        std::deque<Task> queue;
+
+        std::atomic<long long>   busyMicros{0};
+        std::atomic<long long>   idleMicros{0};
+        std::atomic<std::size_t> tasks{0};
+        std::atomic<std::size_t> steals{0};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread>             threads;
+
+    std::mutex              sleepMutex;
+    std::condition_variable wake;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<std::size_t> nextQueue{0};
+    bool                    stopping = false;
+
+    // Identifies the pool worker running on this thread, if any
+    static ThreadPool *&currentPool() {
+        thread_local ThreadPool *pool = nullptr;
+        return pool;
+    }
+
+    static std::size_t &currentIndex() {
+        thread_local std::size_t index = 0;
+        return index;
+    }
+
+    static long long microsSince(std::chrono::steady_clock::time_point t) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t).count();
+    }
+
+    bool popLocal(std::size_t self, Task &out) {
+        Worker &w = *workers[self];
+        std::lock_guard<std::mutex> lock(w.mutex);
+        if (w.queue.empty()) return false;
+        out = std::move(w.queue.back());
+        w.queue.pop_back();
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    bool steal(std::size_t self, Task &out) {
+        const std::size_t n = workers.size();
+        for (std::size_t k = 1; k <= n; ++k) {
+            Worker &victim = *workers[(self + k) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.queue.empty()) continue;
+            out = std::move(victim.queue.front());
+            victim.queue.pop_front();
+            pending.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+        return false;
+    }
+
+    // Grabs one task for `self` (own queue first, then steal)
+    bool acquire(std::size_t self, Task &out, bool &stolen) {
+        stolen = false;
+        if (popLocal(self, out)) return true;
+        if (steal(self, out)) {
+            stolen = true;
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(std::size_t self) {
+        currentPool()  = this;
+        currentIndex() = self;
+        Worker &me = *workers[self];
+
+        while (true) {
+            Task task;
+            bool stolen;
+            if (acquire(self, task, stolen)) {
+                auto t = std::chrono::steady_clock::now();
+                task();
+                me.busyMicros += microsSince(t);
+                me.tasks++;
+                if (stolen) me.steals++;
+                continue;
+            }
+
+            auto t = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] {
+                return stopping || pending.load(std::memory_order_acquire) > 0;
+            });
+            me.idleMicros += microsSince(t);
+            if (stopping && pending.load() == 0) return;
+        }
+    }
+
+    // Runs one queued task on the calling thread; false if none was found
+    bool helpOnce() {
+        Task task;
+        bool stolen;
+        std::size_t self = currentPool() == this ? currentIndex() : 0;
+        if (!acquire(self, task, stolen)) return false;
+        task();
+        return true;
+    }
+
+public:
+    static std::size_t defaultWorkers() {
+        return std::max(2u, std::thread::hardware_concurrency());
+    }
+
+    explicit ThreadPool(std::size_t numWorkers = defaultWorkers()) {
+        if (numWorkers == 0) numWorkers = 1;
+        for (std::size_t i = 0; i < numWorkers; ++i)
+            workers.push_back(std::make_unique<Worker>());
+        for (std::size_t i = 0; i < numWorkers; ++i)
+            threads.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &t : threads) t.join();
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    std::size_t size() const { return workers.size(); }
+
+    // Queues a task. From a worker it goes to that worker's own deque;
+    // from outside, queues are picked round-robin. Tasks given to submit()
+    // must not throw; use async() or parallelFor() for fallible work.
+    void submit(Task task) {
+        std::size_t q = currentPool() == this
+                            ? currentIndex()
+                            : nextQueue.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        {
+            // Counted before it is visible, so `pending` never underflows;
+            // bumped under sleepMutex so a worker about to sleep sees it
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            pending.fetch_add(1, std::memory_order_acq_rel);
+        }
+        {
+            std::lock_guard<std::mutex> lock(workers[q]->mutex);
+            workers[q]->queue.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+    // Queues a task and returns a future for its result
+    template <typename Fn>
+    auto async(Fn fn) -> std::future<decltype(fn())> {
+        using R = decltype(fn());
+        auto job = std::make_shared<std::packaged_task<R()>>(std::move(fn));
+        std::future<R> result = job->get_future();
+        submit([job]() { (*job)(); });
+        return result;
+    }
+
+    // Runs fn(i) for every i in [0, count) and returns when all are done.
+    // The calling thread executes tasks too. The first exception thrown
+    // by any fn(i) is rethrown here.
+    template <typename Fn>
+    void parallelFor(std::size_t count, Fn fn) {
+        if (count == 0) return;
+
+        struct Batch {
+            std::atomic<std::size_t> remaining;
+            std::mutex               errorMutex;
+            std::exception_ptr       error;
+        };
+        auto batch = std::make_shared<Batch>();
+        batch->remaining = count;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            submit([batch, &fn, i]() {
+                try {
+                    fn(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(batch->errorMutex);
+                    if (!batch->error) batch->error = std::current_exception();
+                }
+                batch->remaining.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+
+        while (batch->remaining.load(std::memory_order_acquire) > 0) {
+            if (!helpOnce()) std::this_thread::yield();
+        }
+
+        if (batch->error) std::rethrow_exception(batch->error);
+    }
+
+    std::vector<WorkerStats> stats() const {
+        std::vector<WorkerStats> out;
+        for (const auto &w : workers) {
+            out.push_back({w->busyMicros.load(), w->idleMicros.load(),
+                           w->tasks.load(), w->steals.load()});
+        }
+        return out;
+    }
+
+    void resetStats() {
+        for (auto &w : workers) {
+            w->busyMicros = 0;
+            w->idleMicros = 0;
+            w->tasks = 0;
+            w->steals = 0;
+        }
+    }
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,104 @@
+#ifndef VERSIONED_DATABASE_HPP
+#define VERSIONED_DATABASE_HPP
+
+#include "thread_pool.hpp"
+
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+
+// ========================
+// Snapshot-isolated database (copy-on-write versions)
+// Readers take snapshot(): an immutable, frozen version held by a
+// shared_ptr, and query it without any lock for as long as they like.
+// Writers never touch a published version. update() copies the current
+// version, edits the copy, and publishes it with one atomic pointer
+// store; rebuild() fills a brand-new database (loads) the same way.
+// A version is freed when its last reader drops it.
+//
+// Writers are serialised among themselves; they never wait for readers
+// and readers never wait for them. An update copies the whole database,
+// so batch many edits into one update() call.
+// ========================
+
+template <typename DB>
+class VersionedDatabase {
+public:
+    using Snapshot = std::shared_ptr<const DB>;
+
+private:
+    Snapshot                    current;   // only via std::atomic_load/store
+    std::atomic<std::uint64_t>  number{0};
+    std::mutex                  writer;
+    std::shared_ptr<ThreadPool> pool;      // shared by every version
+
+    // Caller holds `writer`
+    void publishLocked(std::shared_ptr<DB> next) {
+        next->setThreadPool(pool);
+        next->freeze();
+        std::atomic_store_explicit(&current, Snapshot(std::move(next)),
+                                   std::memory_order_release);
+        number.fetch_add(1, std::memory_order_release);
+    }
+
+public:
+    explicit VersionedDatabase(std::shared_ptr<ThreadPool> p = nullptr)
+        : pool(p ? std::move(p) : std::make_shared<ThreadPool>()) {
+        std::lock_guard<std::mutex> lock(writer);
+        publishLocked(std::make_shared<DB>());
+    }
+
+    VersionedDatabase(const VersionedDatabase &) = delete;
+    VersionedDatabase &operator=(const VersionedDatabase &) = delete;
+
+    // The latest published version; never null
+    Snapshot snapshot() const {
+        return std::atomic_load_explicit(&current, std::memory_order_acquire);
+    }
+
+    // Versions published so far (the empty initial one counts)
+    std::uint64_t version() const { return number.load(std::memory_order_acquire); }
+
+    // Applies fn(DB &) to a copy of the latest version and publishes it;
+    // returns whatever fn returns
+    template <typename Fn>
+    auto update(Fn fn) {
+        std::lock_guard<std::mutex> lock(writer);
+        auto next = std::make_shared<DB>(*snapshot());
+        if constexpr (std::is_void_v<decltype(fn(*next))>) {
+            fn(*next);
+            publishLocked(std::move(next));
+        } else {
+            auto result = fn(*next);
+            publishLocked(std::move(next));
+            return result;
+        }
+    }
+
+    // Like update(), but fn starts from an empty database
+    template <typename Fn>
+    auto rebuild(Fn fn) {
+        std::lock_guard<std::mutex> lock(writer);
+        auto next = std::make_shared<DB>();
+        next->setThreadPool(pool);
+        if constexpr (std::is_void_v<decltype(fn(*next))>) {
+            fn(*next);
+            publishLocked(std::move(next));
+        } else {
+            auto result = fn(*next);
+            publishLocked(std::move(next));
+            return result;
+        }
+    }
+
+    // Publishes a database built elsewhere
+    void publish(DB db) {
+        std::lock_guard<std::mutex> lock(writer);
+        publishLocked(std::make_shared<DB>(std::move(db)));
+    }
+};
+
+#endif // VERSIONED_DATABASE_HPP